@@ -2,6 +2,8 @@ QT       += core gui
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
+QT += concurrent
+
 CONFIG += c++17
 
 # You can make your code fail to compile if it uses deprecated APIs.
@@ -15,6 +17,20 @@ SOURCES += main.cpp \
            src/character.cpp \
            src/path.cpp \
            src/box.cpp \
+           src/spriteatlas.cpp \
+           src/boardgrid.cpp \
+           src/boardsolver.cpp \
+           src/boardgenerator.cpp \
+           src/boardlayer.cpp \
+           src/gameclock.cpp \
+           src/gameloop.cpp \
+           src/timerwheel.cpp \
+           src/effectpool.cpp \
+           src/profiler.cpp \
+           src/tracer.cpp \
+           src/gameview.cpp \
+           src/debughud.cpp \
+           src/memoryreport.cpp \
            src/collision.cpp \
            src/map.cpp \
            src/powerupmanager.cpp \
@@ -26,6 +42,20 @@ HEADERS += src/mainwindow.h \
            src/character.h \
            src/path.h \
            src/box.h \
+           src/spriteatlas.h \
+           src/boardgrid.h \
+           src/boardsolver.h \
+           src/boardgenerator.h \
+           src/boardlayer.h \
+           src/gameclock.h \
+           src/gameloop.h \
+           src/timerwheel.h \
+           src/effectpool.h \
+           src/profiler.h \
+           src/tracer.h \
+           src/gameview.h \
+           src/debughud.h \
+           src/memoryreport.h \
            src/collision.h \
            src/map.h \
            src/powerupmanager.h \
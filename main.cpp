@@ -1,11 +1,39 @@
 #include "mainwindow.h"
+#include "profiler.h"
+#include "tracer.h"
 
 #include <QApplication>
+#include <QDebug>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+
+    // --trace：记录游戏事件与热点函数，退出时写出 trace.json（--trace=路径 可指定文件）
+    QString tracePath;
+    for (const QString &arg : a.arguments()) {
+        if (arg == "--trace") tracePath = "trace.json";
+        else if (arg.startsWith("--trace=")) tracePath = arg.mid(int(qstrlen("--trace=")));
+    }
+    Tracer::instance().setEnabled(!tracePath.isEmpty());
+
     MainWindow w;
     w.show();
-    return a.exec();
+    const int result = a.exec();
+
+    // 开启分节计时的构建在退出时导出各分节耗时直方图
+    if (Profiler::isEnabled() && Profiler::instance().sectionCount() > 0) {
+        const QString path = "profile-histogram.txt";
+        if (Profiler::instance().dumpHistograms(path))
+            qDebug() << "Profile histograms written to" << path;
+    }
+
+    if (Tracer::instance().isEnabled()) {
+        Tracer::instance().setEnabled(false);
+        if (Tracer::instance().writeJson(tracePath))
+            qDebug() << "Trace written to" << tracePath << "events:" << Tracer::instance().eventCount();
+        else
+            qWarning() << "Failed to write trace to" << tracePath;
+    }
+    return result;
 }
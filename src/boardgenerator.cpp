@@ -0,0 +1,127 @@
+#include "boardgenerator.h"
+#include <algorithm>
+
+// 构造，传入随机种子
+BoardGenerator::BoardGenerator(quint32 seed)
+    : m_seed(seed),
+    m_rng(seed)
+{
+}
+
+// 从可放置空格表中移除一格（与表尾交换，O(1)）
+void BoardGenerator::takeEmpty(int idx)
+{
+    const int slot = m_emptySlot[idx];
+    if (slot < 0) return;
+    const int last = m_empty.last();
+    m_empty[slot] = last;
+    m_emptySlot[last] = slot;
+    m_empty.removeLast();
+    m_emptySlot[idx] = -1;
+}
+
+// 试着把 a、b 同时放上箱子，两者可连通则保留，否则撤销
+bool BoardGenerator::tryPartner(int a, int b)
+{
+    if (b == a || m_emptySlot[b] < 0) return false;
+
+    const int stride = m_board.stride();
+    m_board.set(a / stride, a % stride, 0);
+    m_board.set(b / stride, b % stride, 0);
+    if (m_board.linkable(a, b)) return true;
+    m_board.set(a / stride, a % stride, -1);
+    m_board.set(b / stride, b % stride, -1);
+    return false;
+}
+
+// 先随机抽几个空格，多数情况下一次命中，棋盘分布也足够分散；
+// 再看四邻（相邻必然直连）；四邻都是箱子时 a 已被围死；否则顺序扫描有限个空格
+// 每对的判定次数有上限，总代价与格子数成线性
+int BoardGenerator::findPartner(int a)
+{
+    for (int i = 0; i < kSampleTries; ++i) {
+        const int b = m_empty[m_rng.bounded(m_empty.size())];
+        if (tryPartner(a, b)) return b;
+    }
+
+    const int stride = m_board.stride();
+    const int neighbors[4] = { a - 1, a + 1, a - stride, a + stride };
+    bool enclosed = true;
+    for (int b : neighbors) {
+        if (tryPartner(a, b)) return b;
+        if (m_board.typeAt(b) == -1) enclosed = false;
+    }
+    if (enclosed) return -1;
+
+    const int n = qMin(int(m_empty.size()), kScanLimit);
+    const int start = m_rng.bounded(m_empty.size());
+    for (int i = 0; i < n; ++i) {
+        const int b = m_empty[(start + i) % m_empty.size()];
+        if (tryPartner(a, b)) return b;
+    }
+    return -1;
+}
+
+// 逆序消除构造：每放一对都保证它在当前棋盘上可连，于是倒序消除时每一步都成立
+// 找不到配对格的空格直接从表中剔除留作空格（放入箱子只会挡住更多路线，以后大多也找不到）
+// 每个空格只被选中一次、判定次数有上限，不做“生成-校验-重来”的循环
+QVector<QVector<int>> BoardGenerator::generate(int rows, int cols, int typeCount)
+{
+    m_removal.clear();
+    m_board.assign(rows, cols, QVector<QVector<int>>());
+
+    const int stride = m_board.stride();
+    m_empty.clear();
+    m_emptySlot.fill(-1, m_board.cellCount());
+    for (int r = 1; r <= rows; ++r) {
+        for (int c = 1; c <= cols; ++c) {
+            const int idx = m_board.index(r, c);
+            m_emptySlot[idx] = m_empty.size();
+            m_empty.append(idx);
+        }
+    }
+
+    // 目标箱子数：按空格比例取整后向下取偶数
+    const int cells = rows * cols;
+    const int targetPairs = typeCount > 0 ? int(cells * (1 - m_emptyRatio)) / 2 : 0;
+
+    QVector<QPair<int, int>> pairs;
+    pairs.reserve(targetPairs);
+    while (pairs.size() < targetPairs && m_empty.size() >= 2) {
+        const int a = m_empty[m_rng.bounded(m_empty.size())];
+        takeEmpty(a);
+        const int b = findPartner(a);
+        if (b < 0) continue;        // a 已无法配对，保持为空
+        takeEmpty(b);
+        pairs.append(qMakePair(a, b));
+    }
+
+    // 从精灵图帧中不重复地挑 typeCount 帧（部分 Fisher–Yates），帧数不够时循环复用
+    QVector<int> frames(m_frameCount);
+    for (int i = 0; i < m_frameCount; ++i) frames[i] = i;
+    const int distinct = qMin(typeCount, m_frameCount);
+    for (int i = 0; i < distinct; ++i)
+        std::swap(frames[i], frames[i + m_rng.bounded(m_frameCount - i)]);
+
+    // 每对一个类型：按对数轮流分配使各类型数量均衡，再打乱对应关系
+    QVector<int> pairTypes(pairs.size());
+    for (int i = 0; i < pairs.size(); ++i)
+        pairTypes[i] = frames[(i % qMax(1, typeCount)) % distinct];
+    for (int i = pairTypes.size() - 1; i > 0; --i)
+        std::swap(pairTypes[i], pairTypes[m_rng.bounded(i + 1)]);
+
+    QVector<QVector<int>> result(rows, QVector<int>(cols, -1));
+    for (int i = 0; i < pairs.size(); ++i) {
+        const int a = pairs[i].first, b = pairs[i].second;
+        result[a / stride - 1][a % stride - 1] = pairTypes[i];
+        result[b / stride - 1][b % stride - 1] = pairTypes[i];
+    }
+
+    // 放置顺序倒过来就是消除顺序
+    for (int i = pairs.size() - 1; i >= 0; --i) {
+        const int a = pairs[i].first, b = pairs[i].second;
+        m_removal.append(qMakePair(QPoint(a % stride - 1, a / stride - 1),
+                                   QPoint(b % stride - 1, b / stride - 1)));
+    }
+    return result;
+}
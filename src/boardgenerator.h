@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QVector>
+#include <QPoint>
+#include <QPair>
+#include <QRandomGenerator>
+#include <QtGlobal>
+#include "boardgrid.h"
+
+// BoardGenerator 类：按“逆序消除”生成保证可全部消除、各类型成对出现的棋盘
+// 从空盘开始每次放入一对能互相连通的箱子，把放置顺序倒过来就是一条完整的消除顺序
+class BoardGenerator {
+public:
+    // 同一种子、同样参数生成的棋盘完全相同
+    explicit BoardGenerator(quint32 seed);
+
+    // 空格比例（0 ~ 1），箱子数取不超过 格子数*(1-比例) 的偶数
+    void setEmptyRatio(qreal ratio) { m_emptyRatio = qBound(qreal(0), ratio, qreal(1)); }
+    // 放置时采用的连线规则（最多拐弯数）
+    void setMaxTurns(int turns) { m_board.setMaxTurns(turns); }
+    // 精灵图可用帧数，类型从中不重复地选取
+    void setFrameCount(int frames) { m_frameCount = qMax(1, frames); }
+
+    // 生成 rows*cols 的类型编号矩阵（-1为空），typeCount 种类型，各类型的对数相差不超过 1
+    QVector<QVector<int>> generate(int rows, int cols, int typeCount);
+
+    // 上一次生成棋盘的一条消除顺序，原map坐标 QPoint(col,row)
+    const QVector<QPair<QPoint, QPoint>>& removalOrder() const { return m_removal; }
+
+    quint32 seed() const { return m_seed; }
+
+private:
+    // 随机抽样的候选配对格数，抽不中再看四邻，最后顺序扫描至多 kScanLimit 个空格
+    static constexpr int kSampleTries = 8;
+    static constexpr int kScanLimit = 64;
+
+    // 为空格 a 找一个当前能与之连通的空格，找不到返回 -1
+    int findPartner(int a);
+    bool tryPartner(int a, int b);
+
+    quint32 m_seed;
+    QRandomGenerator m_rng;
+    qreal m_emptyRatio = 0;
+    int m_frameCount = 62;
+
+    BoardGrid m_board;                  // 放置过程中的棋盘（只关心占用，类型统一记为 0）
+    QVector<int> m_empty;               // 仍可放置的空格（padding 网格下标），无序，交换删除
+    QVector<int> m_emptySlot;           // 空格 -> 在 m_empty 中的位置（-1 表示不在表中）
+    QVector<QPair<QPoint, QPoint>> m_removal;
+
+    void takeEmpty(int idx);
+};
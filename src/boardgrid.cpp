@@ -0,0 +1,631 @@
+#include "boardgrid.h"
+#include <QtAlgorithms>
+#include <QtConcurrent>
+#include <QHash>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// 位图 bits 的 [lo, hi] 区间内是否全为 0（lo > hi 视为空区间）
+bool bitsClear(const quint64 *bits, int lo, int hi)
+{
+    if (lo > hi) return true;
+    const int wLo = lo >> 6;
+    const int wHi = hi >> 6;
+    const quint64 loMask = ~quint64(0) << (lo & 63);
+    const quint64 hiMask = ~quint64(0) >> (63 - (hi & 63));
+    if (wLo == wHi) return (bits[wLo] & loMask & hiMask) == 0;
+    if (bits[wLo] & loMask) return false;
+    for (int w = wLo + 1; w < wHi; ++w)
+        if (bits[w]) return false;
+    return (bits[wHi] & hiMask) == 0;
+}
+
+// 从 from（含）起向高位找第一个置位，n 为位图有效长度，找不到返回 n
+int nextSetBit(const quint64 *bits, int from, int n)
+{
+    if (from >= n) return n;
+    const int words = (n + 63) >> 6;
+    int w = from >> 6;
+    quint64 word = bits[w] & (~quint64(0) << (from & 63));
+    while (!word) {
+        if (++w >= words) return n;
+        word = bits[w];
+    }
+    return std::min(n, (w << 6) + int(qCountTrailingZeroBits(word)));
+}
+
+// 从 from（含）起向低位找第一个置位，找不到返回 -1
+int prevSetBit(const quint64 *bits, int from)
+{
+    if (from < 0) return -1;
+    int w = from >> 6;
+    quint64 word = bits[w] & (~quint64(0) >> (63 - (from & 63)));
+    while (!word) {
+        if (--w < 0) return -1;
+        word = bits[w];
+    }
+    return (w << 6) + 63 - int(qCountLeadingZeroBits(word));
+}
+
+// 方向编号：0上 1右 2下 3左，顺时针相邻即为垂直方向
+const int kDirRow[4] = {-1, 0, 1, 0};
+const int kDirCol[4] = {0, 1, 0, -1};
+
+// 箱子数达到该值才把类型组分发到线程池，小棋盘串行更快
+const int kParallelMinTiles = 256;
+
+} // namespace
+
+// 构造，传入类型编号二维数组，行列数取数组大小
+BoardGrid::BoardGrid(const QVector<QVector<int>>& cells)
+{
+    assign(cells.size(), cells.isEmpty() ? 0 : cells[0].size(), cells);
+}
+
+// 由二维数组重建 padding 网格与行列位图：外圈一圈 -1，内部逐格拷贝，数组缺失的格子视为空
+void BoardGrid::assign(int rows, int cols, const QVector<QVector<int>>& cells)
+{
+    m_rows = rows;
+    m_cols = cols;
+    m_stride = m_cols + 2;
+    m_grid.fill(-1, (m_rows + 2) * m_stride);   // 尺寸不变时复用原有内存
+
+    m_rowWords = (m_stride + 63) / 64;
+    m_colWords = (m_rows + 2 + 63) / 64;
+    m_rowBits.fill(0, (m_rows + 2) * m_rowWords);
+    m_colBits.fill(0, m_stride * m_colWords);
+
+    for (int i = 0; i < m_rows && i < cells.size(); i++) {
+        for (int j = 0; j < m_cols && j < cells[i].size(); j++) {
+            m_grid[index(i + 1, j + 1)] = cells[i][j];
+            setOccupiedBit(i + 1, j + 1, cells[i][j] != -1);
+        }
+    }
+}
+
+qint64 BoardGrid::memoryBytes() const
+{
+    return qint64(m_grid.capacity()) * sizeof(int)
+         + qint64(m_rowBits.capacity() + m_colBits.capacity()) * sizeof(quint64);
+}
+
+// 修改单格类型，传入 padding 网格坐标
+void BoardGrid::set(int r, int c, int type)
+{
+    m_grid[index(r, c)] = type;
+    setOccupiedBit(r, c, type != -1);
+}
+
+// 同步置位/清零 (r,c) 在行位图与列位图中对应的 bit
+void BoardGrid::setOccupiedBit(int r, int c, bool occupied)
+{
+    quint64 &rowWord = m_rowBits[r * m_rowWords + (c >> 6)];
+    quint64 &colWord = m_colBits[c * m_colWords + (r >> 6)];
+    const quint64 rowMask = quint64(1) << (c & 63);
+    const quint64 colMask = quint64(1) << (r & 63);
+    if (occupied) {
+        rowWord |= rowMask;
+        colWord |= colMask;
+    } else {
+        rowWord &= ~rowMask;
+        colWord &= ~colMask;
+    }
+}
+
+// 路径判定
+// 以下坐标均为 padding 网格坐标，直接读取 m_grid 与行列位图，不产生任何临时数组
+// 两个端点本身不必置空：经过端点的路径总能截成拐弯更少的一段，已被先行的直连/一拐判定覆盖
+
+// 同行或同列两点之间（不含端点）是否全空：对行/列位图做区间掩码比较
+bool BoardGrid::lineClear(int r1, int c1, int r2, int c2) const
+{
+    if (r1 == r2)
+        return bitsClear(rowBits(r1), std::min(c1, c2) + 1, std::max(c1, c2) - 1);
+    if (c1 == c2)
+        return bitsClear(colBits(c1), std::min(r1, r2) + 1, std::max(r1, r2) - 1);
+    return false;
+}
+
+// 直线连接，传入两点，成功时向路径数组追加结点
+bool BoardGrid::straightConnect(int r1, int c1, int r2, int c2,
+                                QVector<QPoint>* outPath) const
+{
+    if (!lineClear(r1, c1, r2, c2)) return false;
+    if (outPath) *outPath << QPoint(c1, r1) << QPoint(c2, r2);    //等价于outPath->append()
+    return true;
+}
+
+bool BoardGrid::oneTurnConnect(int r1, int c1, int r2, int c2,
+                               QVector<QPoint>* outPath) const
+{
+    // 拐点1 (r1, c2)
+    if (cellEmpty(r1, c2) &&
+        lineClear(r1, c1, r1, c2) && lineClear(r1, c2, r2, c2)) {
+        if (outPath) *outPath << QPoint(c1, r1) << QPoint(c2, r1) << QPoint(c2, r2);
+        return true;
+    }
+    // 拐点2 (r2, c1)
+    if (cellEmpty(r2, c1) &&
+        lineClear(r1, c1, r2, c1) && lineClear(r2, c1, r2, c2)) {
+        if (outPath) *outPath << QPoint(c1, r1) << QPoint(c1, r2) << QPoint(c2, r2);
+        return true;
+    }
+    return false;
+}
+
+bool BoardGrid::twoTurnConnect(int r1, int c1, int r2, int c2,
+                               QVector<QPoint>* outPath) const
+{
+    const int rows = m_rows + 2;
+    const int cols = m_cols + 2;
+
+    // 横-竖-横：a、b 各自在本行能走到的空白区间取交集，交集中每一列都是候选竖直走廊
+    {
+        const int lo = std::max(prevSetBit(rowBits(r1), c1 - 1), prevSetBit(rowBits(r2), c2 - 1)) + 1;
+        const int hi = std::min(nextSetBit(rowBits(r1), c1 + 1, cols), nextSetBit(rowBits(r2), c2 + 1, cols)) - 1;
+        const int top = std::min(r1, r2), bottom = std::max(r1, r2);
+        for (int c = lo; c <= hi; ++c) {
+            if (c == c1 || c == c2) continue;   // 一拐情形已在 oneTurnConnect 中判定
+            // 两个拐点都落在各自的空白区间内，故整段竖直走廊（含拐点）都必须为空
+            if (bitsClear(colBits(c), top, bottom)) {
+                if (outPath) *outPath << QPoint(c1, r1) << QPoint(c, r1) << QPoint(c, r2) << QPoint(c2, r2);
+                return true;
+            }
+        }
+    }
+
+    // 竖-横-竖：同理，交集中每一行都是候选水平走廊
+    {
+        const int lo = std::max(prevSetBit(colBits(c1), r1 - 1), prevSetBit(colBits(c2), r2 - 1)) + 1;
+        const int hi = std::min(nextSetBit(colBits(c1), r1 + 1, rows), nextSetBit(colBits(c2), r2 + 1, rows)) - 1;
+        const int left = std::min(c1, c2), right = std::max(c1, c2);
+        for (int r = lo; r <= hi; ++r) {
+            if (r == r1 || r == r2) continue;
+            if (bitsClear(rowBits(r), left, right)) {
+                if (outPath) *outPath << QPoint(c1, r1) << QPoint(c1, r) << QPoint(c2, r) << QPoint(c2, r2);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// 分层 BFS 查询最优路径，传入 padding 网格下标
+bool BoardGrid::findPath(int source, int target, QVector<QPoint>* cells, int* turns) const
+{
+    BfsWorkspace &ws = bfsWorkspace();
+    const int pred = bfsSearch(ws, source, target, turns);
+    if (pred < 0) return false;
+
+    if (cells) {
+        QPoint points[MapMove::MaxTurns + 2];
+        const int count = tracePath(ws, pred, target, points);
+        cells->clear();
+        cells->reserve(count);
+        for (int i = 0; i < count; ++i)
+            *cells << points[i];
+    }
+    return true;
+}
+
+// 分层 BFS 连线引擎
+// 第 t 层是恰好拐 t 次到达的 (格子, 方向) 状态；同一层里上一层拐弯产生的起始状态按长度排序，
+// 再与直行扩展的 FIFO 归并，保证状态按长度从小到大出队，首次出队即为 (拐弯数, 长度) 最优
+// 每个状态至多出队一次，开销上界为 O(格子数 * 4)，与拐弯上限无关
+// 搜索缓冲：状态下标 = 格子下标 * 4 + 方向
+struct BoardGrid::BfsWorkspace {
+    QVector<int> mark;      // 状态访问标记（与 stamp 比较，免清空）
+    QVector<int> corner;    // 状态所在线段的起点
+    QVector<int> parent;    // 状态所在线段起点处拐弯前的状态，-1 为出发点
+    QVector<int> hitMark;   // 洪泛模式下箱子格去重标记
+    QVector<BfsEntry> seeds;    // 本层起始状态（上一层拐弯产生）
+    QVector<BfsEntry> next;     // 下一层起始状态
+    QVector<BfsEntry> queue;    // 本层内直行扩展的 FIFO
+    QVector<BfsHit> hits;
+    int stamp = 0;
+
+    // enumerateMoves 的去重表：moveSlot[目标格] = 该目标在输出中的位置，moveOwner 记录写入它的起点批次
+    QVector<int> moveSlot;
+    QVector<int> moveOwner;
+    int moveStamp = 0;
+};
+
+// 每个线程一份缓冲，并发查询互不干扰；大小随棋盘变化按需调整
+BoardGrid::BfsWorkspace& BoardGrid::bfsWorkspace()
+{
+    thread_local BfsWorkspace ws;
+    return ws;
+}
+
+int BoardGrid::bfsSearch(BfsWorkspace &ws, int source, int target, int *outTurns) const
+{
+    const int states = m_grid.size() * 4;
+    if (ws.mark.size() != states) {
+        ws.mark.fill(0, states);
+        ws.corner.resize(states);
+        ws.parent.resize(states);
+        ws.hitMark.fill(0, m_grid.size());
+        ws.stamp = 0;
+    }
+    if (++ws.stamp == 0) {        // 计数回绕时清空标记
+        ws.mark.fill(0);
+        ws.hitMark.fill(0);
+        ws.stamp = 1;
+    }
+
+    const int rows = m_rows + 2;
+    const int cols = m_cols + 2;
+
+    ws.hits.clear();
+    ws.seeds.clear();
+    for (int d = 0; d < 4; ++d)
+        ws.seeds.append({source, d, 0, source, -1});
+
+    int bestPred = -1;
+    int bestLen = std::numeric_limits<int>::max();
+
+    for (int turns = 0; turns <= m_maxTurns && !ws.seeds.isEmpty(); ++turns) {
+        std::sort(ws.seeds.begin(), ws.seeds.end(),
+                  [](const BfsEntry &x, const BfsEntry &y) { return x.len < y.len; });
+        ws.queue.clear();
+        ws.next.clear();
+
+        int head = 0, seed = 0;
+        while (seed < ws.seeds.size() || head < ws.queue.size()) {
+            const bool fromQueue = head < ws.queue.size() &&
+                                   (seed >= ws.seeds.size() || ws.queue[head].len < ws.seeds[seed].len);
+            const BfsEntry e = fromQueue ? ws.queue[head++] : ws.seeds[seed++];
+            if (bestPred >= 0 && e.len + 1 >= bestLen) break;   // 本层已不可能更短
+
+            const int state = e.cell * 4 + e.dir;
+            if (ws.mark[state] == ws.stamp) continue;
+            ws.mark[state] = ws.stamp;
+            ws.corner[state] = e.corner;
+            ws.parent[state] = e.parent;
+
+            // 在此处拐弯，留给下一层
+            if (turns < m_maxTurns && e.cell != source) {
+                ws.next.append({e.cell, (e.dir + 1) & 3, e.len, e.cell, state});
+                ws.next.append({e.cell, (e.dir + 3) & 3, e.len, e.cell, state});
+            }
+
+            // 沿当前方向前进一格
+            const int nr = e.cell / m_stride + kDirRow[e.dir];
+            const int nc = e.cell % m_stride + kDirCol[e.dir];
+            if (nr < 0 || nr >= rows || nc < 0 || nc >= cols) continue;
+            const int next = index(nr, nc);
+
+            if (next == target) {
+                if (e.len + 1 < bestLen) {
+                    bestLen = e.len + 1;
+                    bestPred = state;
+                }
+                continue;
+            }
+            if (m_grid[next] != -1) {
+                if (target < 0 && next != source && ws.hitMark[next] != ws.stamp) {
+                    ws.hitMark[next] = ws.stamp;
+                    ws.hits.append({next, turns, state});
+                }
+                continue;
+            }
+            ws.queue.append({next, e.dir, e.len + 1, e.corner, e.parent});
+        }
+
+        if (bestPred >= 0) {
+            if (outTurns) *outTurns = turns;
+            return bestPred;
+        }
+        ws.seeds.swap(ws.next);
+    }
+    return -1;
+}
+
+// 沿前驱链回溯：每个状态记录了所在线段的起点，父状态即上一段，直到出发点
+int BoardGrid::tracePath(const BfsWorkspace &ws, int pred, int endCell, QPoint *out) const
+{
+    int count = 0;
+    out[count++] = QPoint(endCell % m_stride, endCell / m_stride);
+    for (int state = pred; state != -1; state = ws.parent[state]) {
+        const int corner = ws.corner[state];
+        out[count++] = QPoint(corner % m_stride, corner / m_stride);
+    }
+    std::reverse(out, out + count);
+    return count;
+}
+
+// 仅判定两格（padding 网格下标）能否在规则拐弯数以内连通，不记录路径
+// 默认两拐规则走位图级联判定，其余规则交给通用 BFS
+bool BoardGrid::linkable(int a, int b) const
+{
+    if (m_maxTurns != 2)
+        return bfsSearch(bfsWorkspace(), a, b) >= 0;
+    const int r1 = a / m_stride, c1 = a % m_stride;
+    const int r2 = b / m_stride, c2 = b % m_stride;
+    return straightConnect(r1, c1, r2, c2, nullptr) ||
+           oneTurnConnect(r1, c1, r2, c2, nullptr) ||
+           twoTurnConnect(r1, c1, r2, c2, nullptr);
+}
+
+// 射线扫描：从 (r,c) 出发沿空格直走、拐一次、拐两次，每条射线尽头撞到的箱子格回调 visit
+// 每段射线的空白区间由行列位图直接求出，最后一段只需要区间端点，不必逐格行走
+template <typename Visit>
+void BoardGrid::sweepReach(int r, int c, Visit &&visit) const
+{
+    const int rows = m_rows + 2;
+    const int cols = m_cols + 2;
+    const int origin = index(r, c);
+
+    auto hit = [&](int rr, int cc, int turns, const QPoint &k1, const QPoint &k2) {
+        if (rr < 0 || rr >= rows || cc < 0 || cc >= cols) return;
+        const int idx = index(rr, cc);
+        if (idx != origin) visit(idx, turns, k1, k2);
+    };
+    // (rr,cc) 所在行/列的空白区间（不看 (rr,cc) 自身）
+    auto rowRun = [&](int rr, int cc, int &lo, int &hi) {
+        lo = prevSetBit(rowBits(rr), cc - 1) + 1;
+        hi = nextSetBit(rowBits(rr), cc + 1, cols) - 1;
+    };
+    auto colRun = [&](int rr, int cc, int &lo, int &hi) {
+        lo = prevSetBit(colBits(cc), rr - 1) + 1;
+        hi = nextSetBit(colBits(cc), rr + 1, rows) - 1;
+    };
+
+    const QPoint none;
+    int lo0, hi0, lo1, hi1, lo2, hi2;
+
+    // 先横走：拐点依次为 (r,c1)、(r1,c1)
+    rowRun(r, c, lo0, hi0);
+    hit(r, lo0 - 1, 0, none, none);
+    hit(r, hi0 + 1, 0, none, none);
+    for (int c1 = lo0; c1 <= hi0; ++c1) {
+        if (c1 == c) continue;
+        const QPoint k1(c1, r);
+        colRun(r, c1, lo1, hi1);
+        hit(lo1 - 1, c1, 1, k1, none);
+        hit(hi1 + 1, c1, 1, k1, none);
+        for (int r1 = lo1; r1 <= hi1; ++r1) {
+            if (r1 == r) continue;
+            const QPoint k2(c1, r1);
+            rowRun(r1, c1, lo2, hi2);
+            hit(r1, lo2 - 1, 2, k1, k2);
+            hit(r1, hi2 + 1, 2, k1, k2);
+        }
+    }
+
+    // 先竖走：拐点依次为 (r1,c)、(r1,c1)
+    colRun(r, c, lo0, hi0);
+    hit(lo0 - 1, c, 0, none, none);
+    hit(hi0 + 1, c, 0, none, none);
+    for (int r1 = lo0; r1 <= hi0; ++r1) {
+        if (r1 == r) continue;
+        const QPoint k1(c, r1);
+        rowRun(r1, c, lo1, hi1);
+        hit(r1, lo1 - 1, 1, k1, none);
+        hit(r1, hi1 + 1, 1, k1, none);
+        for (int c1 = lo1; c1 <= hi1; ++c1) {
+            if (c1 == c) continue;
+            const QPoint k2(c1, r1);
+            colRun(r1, c1, lo2, hi2);
+            hit(lo2 - 1, c1, 2, k1, k2);
+            hit(hi2 + 1, c1, 2, k1, k2);
+        }
+    }
+}
+
+// 收集射线可达的箱子格（去重，不关心路径），结果写入 reach.cells
+void BoardGrid::collectReach(int idx, Reach& reach) const
+{
+    reach.cells.clear();
+    if (reach.mark.size() != m_grid.size()) {
+        reach.mark.fill(0, m_grid.size());
+        reach.stamp = 0;
+    }
+    if (++reach.stamp == 0) {       // 计数回绕时清空标记
+        reach.mark.fill(0);
+        reach.stamp = 1;
+    }
+
+    auto collect = [&reach](int cell) {
+        if (reach.mark[cell] == reach.stamp) return;
+        reach.mark[cell] = reach.stamp;
+        reach.cells.append(cell);
+    };
+
+    // 非两拐规则时，可达范围由 BFS 洪泛求出
+    if (m_maxTurns != 2) {
+        BfsWorkspace &ws = bfsWorkspace();
+        bfsSearch(ws, idx, -1);
+        for (const BfsHit &hit : std::as_const(ws.hits))
+            collect(hit.cell);
+        return;
+    }
+
+    sweepReach(idx / m_stride, idx % m_stride, [&collect](int cell, int, const QPoint &, const QPoint &) {
+        collect(cell);
+    });
+}
+
+// 批量列出全部可消对：每个箱子做一次射线扫描，只保留下标更大的同类型目标（每对只出现一次）
+// 同一目标被多条路线射到时保留拐弯最少的一条；扫描量与各箱子射线覆盖的空格数成正比
+void BoardGrid::enumerateMoves(QVector<MapMove>& out) const
+{
+    out.clear();
+
+    // 非两拐规则：每个箱子做一次 BFS 洪泛，命中列表已按格去重且为最少拐弯
+    if (m_maxTurns != 2) {
+        BfsWorkspace &ws = bfsWorkspace();
+        for (int idx = 0; idx < m_grid.size(); ++idx) {
+            const int type = m_grid[idx];
+            if (type == -1) continue;
+            bfsSearch(ws, idx, -1);
+            for (const BfsHit &hit : std::as_const(ws.hits)) {
+                if (hit.cell < idx || m_grid[hit.cell] != type) continue;
+                MapMove move;
+                move.r1 = idx / m_stride - 1;
+                move.c1 = idx % m_stride - 1;
+                move.r2 = hit.cell / m_stride - 1;
+                move.c2 = hit.cell % m_stride - 1;
+                move.turns = hit.turns;
+                move.pointCount = tracePath(ws, hit.pred, hit.cell, move.points);
+                out.append(move);
+            }
+        }
+        return;
+    }
+
+    // 去重表放在线程的搜索缓冲里跨调用复用；每个起点取一个新批次号，免去每个起点清空
+    BfsWorkspace &ws = bfsWorkspace();
+    if (ws.moveOwner.size() != m_grid.size()) {
+        ws.moveOwner.fill(0, m_grid.size());
+        ws.moveSlot.resize(m_grid.size());
+        ws.moveStamp = 0;
+    }
+    QVector<int> &slotOf = ws.moveSlot;
+    QVector<int> &ownerOf = ws.moveOwner;
+
+    for (int idx = 0; idx < m_grid.size(); ++idx) {
+        const int type = m_grid[idx];
+        if (type == -1) continue;
+
+        if (++ws.moveStamp == 0) {    // 计数回绕时清空标记
+            ownerOf.fill(0);
+            ws.moveStamp = 1;
+        }
+        const int stamp = ws.moveStamp;
+
+        const int r = idx / m_stride, c = idx % m_stride;
+        sweepReach(r, c, [&](int target, int turns, const QPoint &k1, const QPoint &k2) {
+            if (target < idx || m_grid[target] != type) return;
+
+            MapMove *move = nullptr;
+            if (ownerOf[target] == stamp) {
+                move = &out[slotOf[target]];
+                if (move->turns <= turns) return;   // 已有不多于当前拐弯数的路线
+            } else {
+                ownerOf[target] = stamp;
+                slotOf[target] = out.size();
+                out.append(MapMove());
+                move = &out.last();
+            }
+
+            const int tr = target / m_stride, tc = target % m_stride;
+            move->r1 = r - 1;
+            move->c1 = c - 1;
+            move->r2 = tr - 1;
+            move->c2 = tc - 1;
+            move->turns = turns;
+            move->pointCount = turns + 2;
+            move->points[0] = QPoint(c, r);
+            if (turns >= 1) move->points[1] = k1;
+            if (turns == 2) move->points[2] = k2;
+            move->points[turns + 1] = QPoint(tc, tr);
+        });
+    }
+}
+
+// 按类型收集箱子所在格，组的顺序为类型首次出现的顺序
+QVector<QVector<int>> BoardGrid::typeGroups() const
+{
+    QVector<QVector<int>> groups;
+    QHash<int, int> groupOf;
+    for (int idx = 0; idx < m_grid.size(); ++idx) {
+        const int type = m_grid[idx];
+        if (type == -1) continue;
+        int slot = groupOf.value(type, -1);
+        if (slot < 0) {
+            slot = groups.size();
+            groupOf.insert(type, slot);
+            groups.append(QVector<int>());
+        }
+        groups[slot].append(idx);
+    }
+    return groups;
+}
+
+// 组内每个箱子做一次射线扩展，同类型且下标更大的即为一对
+void BoardGrid::groupMoves(const QVector<int>& group, QVector<QPair<int, int>>& out,
+                           bool firstOnly, const std::atomic_bool* cancel) const
+{
+    Reach reach;
+    for (int idx : group) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) return;
+        collectReach(idx, reach);
+        const int type = m_grid[idx];
+        for (int other : std::as_const(reach.cells)) {
+            if (other <= idx || m_grid[other] != type) continue;
+            out.append(qMakePair(idx, other));
+            if (firstOnly) return;
+        }
+    }
+}
+
+QVector<QPair<int, int>> BoardGrid::allMoves() const
+{
+    const QVector<QVector<int>> groups = typeGroups();
+    std::vector<QVector<QPair<int, int>>> results(groups.size());
+
+    int tiles = 0;
+    for (const QVector<int> &group : groups) tiles += group.size();
+
+    if (tiles < kParallelMinTiles || groups.size() < 2) {
+        for (int g = 0; g < groups.size(); ++g)
+            groupMoves(groups[g], results[g]);
+    } else {
+        // 每组只读共享棋盘、只写自己的结果槽，无需加锁
+        QVector<int> order(groups.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&groups](int x, int y) {
+            return groups[x].size() > groups[y].size();     // 大组先发，负载更均衡
+        });
+        QtConcurrent::blockingMap(order, [this, &groups, &results](const int &g) {
+            groupMoves(groups[g], results[g]);
+        });
+    }
+
+    QVector<QPair<int, int>> moves;
+    for (const QVector<QPair<int, int>> &part : results)
+        moves += part;
+    return moves;
+}
+
+bool BoardGrid::findAnyMove(QPair<int, int>* out) const
+{
+    const QVector<QVector<int>> groups = typeGroups();
+    std::vector<QVector<QPair<int, int>>> results(groups.size());
+
+    int tiles = 0;
+    for (const QVector<int> &group : groups) tiles += group.size();
+
+    if (tiles < kParallelMinTiles || groups.size() < 2) {
+        for (int g = 0; g < groups.size(); ++g) {
+            groupMoves(groups[g], results[g], true);
+            if (!results[g].isEmpty()) {
+                if (out) *out = results[g].first();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::atomic_bool found(false);
+    QVector<int> order(groups.size());
+    std::iota(order.begin(), order.end(), 0);
+    QtConcurrent::blockingMap(order, [this, &groups, &results, &found](const int &g) {
+        groupMoves(groups[g], results[g], true, &found);
+        if (!results[g].isEmpty()) found.store(true, std::memory_order_relaxed);
+    });
+
+    for (const QVector<QPair<int, int>> &part : results) {
+        if (!part.isEmpty()) {
+            if (out) *out = part.first();
+            return true;
+        }
+    }
+    return false;
+}
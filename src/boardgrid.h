@@ -0,0 +1,136 @@
+#pragma once
+
+#include <QVector>
+#include <QPoint>
+#include <QPair>
+#include <QtGlobal>
+#include <atomic>
+
+// 一条可消对及其连线（enumerateMoves 的输出单元，定长存储，不做额外分配）
+struct MapMove {
+    static constexpr int MaxTurns = 4;  // 规则允许设置的最大拐弯数上限
+
+    int r1, c1;             // 起点（原map坐标）
+    int r2, c2;             // 终点（原map坐标）
+    int turns;              // 拐弯数
+    int pointCount;         // 路径结点数 = turns + 2
+    QPoint points[MaxTurns + 2];    // 路径结点，padding 网格坐标 QPoint(col,row)，与 MapPath::cells 一致
+};
+
+// BoardGrid 类：padding 网格、行列占用位图与连线判定，不涉及场景和 Box
+// 成员全部是隐式共享容器，拷贝一份即得到 O(1) 的不可变快照，可交给工作线程搜索
+class BoardGrid {
+public:
+    BoardGrid() = default;
+    explicit BoardGrid(const QVector<QVector<int>>& cells);
+
+    // 由类型编号二维数组按给定行列数整体重建（外圈补一圈 -1）
+    void assign(int rows, int cols, const QVector<QVector<int>>& cells);
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+    int stride() const { return m_stride; }             // padding 网格的行宽（cols+2）
+    int cellCount() const { return m_grid.size(); }     // padding 网格的格子总数
+    // 网格与行列位图占用的堆内存（按容量计，字节）
+    qint64 memoryBytes() const;
+
+    // padding 网格坐标 -> 一维下标（原map坐标需各加 1）
+    int index(int r, int c) const { return r * m_stride + c; }
+    int typeAt(int idx) const { return m_grid[idx]; }
+
+    // 修改单格类型（padding 网格坐标，-1为空），同步维护行列位图
+    void set(int r, int c, int type);
+
+    // 连线规则：最多允许拐几次弯（0 ~ MapMove::MaxTurns）
+    int maxTurns() const { return m_maxTurns; }
+    void setMaxTurns(int turns) { m_maxTurns = qBound(0, turns, int(MapMove::MaxTurns)); }
+
+    // 仅判定两格（padding 网格下标）能否在规则拐弯数以内连通（两拐规则走位图快速判定）
+    bool linkable(int a, int b) const;
+
+    // 拐弯最少、其次最短的路径；成功时写出路径结点（padding 网格坐标）与拐弯数
+    bool findPath(int source, int target, QVector<QPoint>* cells, int* turns) const;
+
+    // 从某格出发规则拐弯数以内能射到的所有箱子格（不含自身）；缓冲与去重标记由调用方持有，重复使用
+    struct Reach {
+        QVector<int> cells;
+        QVector<int> mark;
+        int stamp = 0;
+    };
+    void collectReach(int idx, Reach& reach) const;
+
+    // 一次扫描列出全部可消对及其最少拐弯路径；去重表在线程的搜索缓冲里复用，稳定后除输出外不再分配
+    void enumerateMoves(QVector<MapMove>& out) const;
+
+    // ---- 按类型分组搜索：不同类型互不相干，可分发到线程池并行 ----
+    // 各类型箱子所在格（padding 网格下标），每组一个类型
+    QVector<QVector<int>> typeGroups() const;
+
+    // 组内可消对（first < second）；firstOnly 时找到一对即返回，cancel 被置位时尽快退出
+    void groupMoves(const QVector<int>& group, QVector<QPair<int, int>>& out,
+                    bool firstOnly = false, const std::atomic_bool* cancel = nullptr) const;
+
+    // 全部可消对，箱子较多时各类型组并行计算
+    QVector<QPair<int, int>> allMoves() const;
+
+    // 任找一对可消对，箱子较多时各组并行，任一组找到即取消其余组
+    bool findAnyMove(QPair<int, int>* out = nullptr) const;
+
+private:
+    int m_rows = 0;
+    int m_cols = 0;
+    int m_stride = 0;
+    int m_maxTurns = 2;
+
+    // 常驻的 padding 网格：(rows+2)*(cols+2) 的一维连续数组，外圈恒为 -1
+    QVector<int> m_grid;
+
+    // 行/列占用位图（同样基于 padding 网格）：bit 为 1 表示该格有箱子
+    // 第 r 行占 m_rowWords 个 64 位字，第 c 列占 m_colWords 个，支持远大于 64 的边长
+    QVector<quint64> m_rowBits;
+    QVector<quint64> m_colBits;
+    int m_rowWords = 0;
+    int m_colWords = 0;
+
+    bool cellEmpty(int r, int c) const { return m_grid[index(r, c)] == -1; }
+    const quint64* rowBits(int r) const { return m_rowBits.constData() + r * m_rowWords; }
+    const quint64* colBits(int c) const { return m_colBits.constData() + c * m_colWords; }
+
+    // 维护单格的行列位图，传入 padding 网格坐标
+    void setOccupiedBit(int r, int c, bool occupied);
+
+    // 同行/同列两点之间（不含端点）是否全为空格，位图按字做掩码比较
+    bool lineClear(int r1, int c1, int r2, int c2) const;
+
+    // 直连、一拐、二拐路径判定（传入 padding 网格坐标，成功时向 outPath 追加路径点，传 nullptr 则只判定）
+    bool straightConnect(int r1, int c1, int r2, int c2,
+                         QVector<QPoint>* outPath) const;
+
+    bool oneTurnConnect(int r1, int c1, int r2, int c2,
+                        QVector<QPoint>* outPath) const;
+
+    bool twoTurnConnect(int r1, int c1, int r2, int c2,
+                        QVector<QPoint>* outPath) const;
+
+    // 射线扫描：从 padding 网格格子 (r,c) 出发两拐以内能射到的每个箱子格都回调一次
+    // visit(格子下标, 拐弯数, 拐点1, 拐点2)，同一格可能被不同路线重复回调
+    template <typename Visit>
+    void sweepReach(int r, int c, Visit &&visit) const;
+
+    // ---- 通用 k 拐 BFS 连线引擎 ----
+    // 队列元素：当前格、前进方向、已走长度、本段起点（拐点）、拐弯前所处的状态
+    struct BfsEntry { int cell; int dir; int len; int corner; int parent; };
+    // 洪泛模式下撞到的箱子：格子、拐弯数、前驱状态
+    struct BfsHit { int cell; int turns; int pred; };
+
+    // 搜索缓冲（定义见 boardgrid.cpp），每个线程一份，跨调用复用，棋盘本身不持有可变状态
+    struct BfsWorkspace;
+    static BfsWorkspace& bfsWorkspace();
+
+    // 从 source 出发按拐弯数分层搜索，层内按长度扩展；target >= 0 时返回到达目标的最优前驱状态（-1 表示不可达），
+    // target < 0 时遍历全部可达状态，把能射到的箱子写入 ws.hits
+    int bfsSearch(BfsWorkspace &ws, int source, int target, int *outTurns = nullptr) const;
+
+    // 由前驱状态回溯拐点，写出从起点到 endCell 的路径结点（padding 网格坐标），返回结点数
+    int tracePath(const BfsWorkspace &ws, int pred, int endCell, QPoint *out) const;
+};
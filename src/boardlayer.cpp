@@ -0,0 +1,127 @@
+#include "boardlayer.h"
+#include "spriteatlas.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <cmath>
+
+namespace {
+
+// 与 Box 的显示参数保持一致
+const qreal kNormalScale = 1.5;     // 普通状态缩放
+const qreal kActiveScale = 2.0;     // 选中/提示状态缩放
+const qreal kGlowRadius = SpriteAtlas::GlowRadius;  // 光晕大小
+
+} // namespace
+
+// 构造，传入行列数、spritesheet贴图路径、单帧方形贴图边长（pix）
+BoardLayer::BoardLayer(int rows, int cols, const QString &spriteSheetPath, int frameSize,
+                       QGraphicsItem *parent)
+    : QGraphicsItem(parent),
+    m_rows(rows),
+    m_cols(cols),
+    m_spriteSheetPath(spriteSheetPath),
+    m_frameSize(frameSize),
+    m_cells(rows * cols)
+{
+    // 让 paint() 拿到精确的暴露区域，只重画脏格子
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+    setZValue(1);
+}
+
+void BoardLayer::setGeometry(const QPointF &origin, qreal spacing)
+{
+    prepareGeometryChange();
+    m_origin = origin;
+    m_spacing = spacing;
+}
+
+void BoardLayer::setTile(int r, int c, int type)
+{
+    Cell &cell = m_cells[r * m_cols + c];
+    if (cell.type == type && cell.flags == 0) return;
+    cell.type = type;
+    cell.flags = 0;
+    markDirty(r, c);
+}
+
+void BoardLayer::setCellFlag(int r, int c, CellFlag flag, bool on)
+{
+    Cell &cell = m_cells[r * m_cols + c];
+    const int flags = on ? (cell.flags | flag) : (cell.flags & ~flag);
+    if (flags == cell.flags) return;
+    cell.flags = flags;
+    markDirty(r, c);
+}
+
+void BoardLayer::setCellGlow(int r, int c, const QColor &glow)
+{
+    Cell &cell = m_cells[r * m_cols + c];
+    if (cell.glow == glow) return;
+    cell.glow = glow;
+    if (cell.flags & (Selected | Hinted)) markDirty(r, c);
+}
+
+qreal BoardLayer::cellExtent() const
+{
+    return m_frameSize * kActiveScale / 2 + kGlowRadius;
+}
+
+QRectF BoardLayer::cellRect(int r, int c) const
+{
+    const QPointF center(m_origin.x() + c * m_spacing, m_origin.y() + r * m_spacing);
+    const qreal e = cellExtent();
+    return QRectF(center.x() - e, center.y() - e, 2 * e, 2 * e);
+}
+
+QRectF BoardLayer::boundingRect() const
+{
+    if (m_rows == 0 || m_cols == 0) return QRectF();
+    return cellRect(0, 0).united(cellRect(m_rows - 1, m_cols - 1));
+}
+
+// 由暴露区域反推需要重画的行列范围，逐格画；高亮格直接画图集里预渲染好的贴图
+void BoardLayer::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget);
+
+    const QRectF exposed = option ? option->exposedRect : boundingRect();
+    const qreal e = cellExtent();
+    const int c0 = qMax(0, int(std::floor((exposed.left() - e - m_origin.x()) / m_spacing)));
+    const int c1 = qMin(m_cols - 1, int(std::ceil((exposed.right() + e - m_origin.x()) / m_spacing)));
+    const int r0 = qMax(0, int(std::floor((exposed.top() - e - m_origin.y()) / m_spacing)));
+    const int r1 = qMin(m_rows - 1, int(std::ceil((exposed.bottom() + e - m_origin.y()) / m_spacing)));
+
+    SpriteAtlas &atlas = SpriteAtlas::instance();
+    m_lastPainted = 0;
+    for (int r = r0; r <= r1; ++r) {
+        for (int c = c0; c <= c1; ++c) {
+            const Cell &cell = m_cells[r * m_cols + c];
+            if (cell.type == -1) continue;
+
+            // 按该格当前状态实际画到的范围判断是否与暴露区域相交
+            const bool active = cell.flags & (Selected | Hinted);
+            const qreal scale = active ? kActiveScale : kNormalScale;
+            const QPointF center(m_origin.x() + c * m_spacing, m_origin.y() + r * m_spacing);
+            const qreal half = m_frameSize * scale / 2 + (active ? kGlowRadius : 0);
+            if (!QRectF(center.x() - half, center.y() - half, 2 * half, 2 * half).intersects(exposed)) continue;
+
+            const QPixmap sprite = atlas.frame(m_spriteSheetPath, cell.type);
+            if (sprite.isNull()) continue;
+
+            if (active || (cell.flags & Preselected)) {
+                const QPixmap look = atlas.decorated(sprite, scale,
+                                                     active ? cell.glow : QColor(),
+                                                     cell.flags & Preselected);
+                painter->drawPixmap(QPointF(center.x() - look.width() / 2.0,
+                                            center.y() - look.height() / 2.0), look);
+            } else {
+                const QRectF target(center.x() - sprite.width() * scale / 2,
+                                    center.y() - sprite.height() * scale / 2,
+                                    sprite.width() * scale, sprite.height() * scale);
+                painter->drawPixmap(target, sprite, QRectF(sprite.rect()));
+            }
+
+            ++m_lastPainted;
+        }
+    }
+}
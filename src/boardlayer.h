@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QGraphicsItem>
+#include <QVector>
+#include <QColor>
+#include <QPointF>
+#include <QString>
+
+// BoardLayer 类：批量绘制模式下的棋盘图层，一个图元在一次 paint() 里画出全部箱子
+// 贴图来自 SpriteAtlas 共享的帧；每格记录类型与状态（选中、预选、提示），
+// 状态变化只把该格所在的小矩形标脏，重绘时按暴露区域只画相交的格子
+class BoardLayer : public QGraphicsItem {
+public:
+    enum CellFlag {
+        Selected    = 0x1,      // 玩家选中（放大 + 发光）
+        Preselected = 0x2,      // 角色靠近（黑色遮罩）
+        Hinted      = 0x4       // 提示道具高亮（放大 + 发光）
+    };
+
+    BoardLayer(int rows, int cols, const QString &spriteSheetPath, int frameSize,
+               QGraphicsItem *parent = nullptr);
+
+    // 格子几何：第 (0,0) 格中心的场景坐标与格距
+    void setGeometry(const QPointF &origin, qreal spacing);
+
+    // 单格类型（-1为空），改类型时该格状态一并清除
+    void setTile(int r, int c, int type);
+    int tileAt(int r, int c) const { return m_cells[r * m_cols + c].type; }
+
+    // 单格状态位，glow 为选中/提示时的发光颜色
+    void setCellFlag(int r, int c, CellFlag flag, bool on);
+    void setCellGlow(int r, int c, const QColor &glow);
+    int cellFlags(int r, int c) const { return m_cells[r * m_cols + c].flags; }
+
+    // 上一次 paint() 实际画了几个格子（用于检查脏矩形是否生效）
+    int lastPaintedCells() const { return m_lastPainted; }
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+               QWidget *widget = nullptr) override;
+
+private:
+    struct Cell {
+        int type = -1;
+        int flags = 0;
+        QColor glow = Qt::yellow;
+    };
+
+    int m_rows;
+    int m_cols;
+    QString m_spriteSheetPath;
+    int m_frameSize;
+    QPointF m_origin;
+    qreal m_spacing = 1;
+    QVector<Cell> m_cells;
+    int m_lastPainted = 0;
+
+    // 一格在任何状态下可能画到的范围的半边长（放大后的贴图 + 光晕）
+    qreal cellExtent() const;
+    QRectF cellRect(int r, int c) const;
+    void markDirty(int r, int c) { update(cellRect(r, c)); }
+};
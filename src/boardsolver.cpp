@@ -0,0 +1,279 @@
+#include "boardsolver.h"
+#include <QRandomGenerator>
+#include <QHash>
+#include <algorithm>
+
+namespace {
+
+// splitmix64：由求解序号得到分布均匀的置换表盐值
+quint64 tableSalt(quint64 n)
+{
+    quint64 z = n * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+// 构造，传入置换表内存上限（字节）
+BoardSolver::BoardSolver(int tableBytes)
+{
+    int entries = 1;
+    while (entries * 2 * int(sizeof(quint64)) <= tableBytes)
+        entries *= 2;
+    m_table.fill(0, entries);
+    m_tableMask = quint64(entries - 1);
+}
+
+// 求解入口：复制棋盘、压缩类型编号、生成 Zobrist 键，然后深度优先搜索
+BoardSolver::Result BoardSolver::solve(const BoardGrid& board)
+{
+    m_timer.start();
+    m_result = Result();
+    m_board = board;
+    m_aborted = false;
+    m_limitHit = false;
+    m_path.clear();
+    m_sleeping.clear();
+    m_sleepStack.clear();
+
+    // 置换表不清空：每次求解换一个盐值与局面哈希混合后存取，上一次留下的表项自然失效
+    m_tableSalt = tableSalt(++m_generation);
+
+    // 类型编号可能是任意精灵帧号，压缩成 0..n-1 便于计数
+    const int cells = m_board.cellCount();
+    QHash<int, int> dense;
+    m_tiles.clear();
+    m_typeOf.fill(-1, cells);
+    m_typeLeft.clear();
+    for (int idx = 0; idx < cells; ++idx) {
+        const int type = m_board.typeAt(idx);
+        if (type == -1) continue;
+        int id = dense.value(type, -1);
+        if (id < 0) {
+            id = m_typeLeft.size();
+            dense.insert(type, id);
+            m_typeLeft.append(0);
+        }
+        m_typeOf[idx] = id;
+        ++m_typeLeft[id];
+        m_tiles.append(idx);
+    }
+
+    // 某类型数量为奇数时必然消不完
+    for (int count : std::as_const(m_typeLeft)) {
+        if (count % 2 != 0) {
+            m_result.elapsedUs = m_timer.nsecsElapsed() / 1000;
+            return m_result;
+        }
+    }
+
+    // 固定种子，同一棋盘的哈希与搜索过程可复现
+    QRandomGenerator rng(0x51ed);
+    m_zobrist.resize(cells);
+    quint64 hash = 0;
+    for (int idx = 0; idx < cells; ++idx) {
+        m_zobrist[idx] = rng.generate64();
+        if (m_typeOf[idx] != -1) hash ^= m_zobrist[idx];
+    }
+
+    m_moveStack.resize(m_tiles.size() / 2 + 1);
+    m_typeChecked.fill(0, m_typeLeft.size());
+    m_checkStamp = 0;
+
+    // 带重启的搜索：每轮节点预算翻倍，同优先级的走法换一种随机次序
+    // 置换表只记录已证明无解的局面，跨轮次依然有效；休眠集与路径在每轮结束时已回溯清空
+    qint64 budget = kFirstRoundNodes;
+    for (int round = 0; ; ++round) {
+        m_aborted = false;
+        m_roundLimit = m_result.nodes + budget;
+        m_shuffle = round > 0;
+        m_rng.seed(quint32(round));
+        m_result.solvable = search(m_tiles.size(), hash, 0);
+        if (m_result.solvable || !m_aborted || m_limitHit) break;
+        budget *= 2;
+        ++m_result.restarts;
+    }
+    m_result.finished = m_result.solvable || !m_aborted;
+    if (m_result.solvable) {
+        const int stride = m_board.stride();
+        for (const QPair<int, int> &step : std::as_const(m_path)) {
+            m_result.solution.append(qMakePair(
+                QPoint(step.first % stride - 1, step.first / stride - 1),
+                QPoint(step.second % stride - 1, step.second / stride - 1)));
+        }
+    }
+    m_result.elapsedUs = m_timer.nsecsElapsed() / 1000;
+    return m_result;
+}
+
+// 列出当前全部可消对，order 为该类型剩余数量（越少越先试）
+void BoardSolver::generateMoves(QVector<Move>& moves) const
+{
+    moves.clear();
+    for (int idx : m_tiles) {
+        const int type = m_typeOf[idx];
+        if (m_board.typeAt(idx) == -1) continue;
+        m_board.collectReach(idx, m_reach);
+        for (int other : std::as_const(m_reach.cells)) {
+            if (other > idx && m_typeOf[other] == type && m_board.typeAt(other) != -1)
+                moves.append({idx, other, m_typeLeft[type]});
+        }
+    }
+}
+
+// 在当前可消对里找一个剩余数量不超过 kClearLimit 的类型，检查它能否现在就全部消掉
+bool BoardSolver::findClearableType(const QVector<Move>& moves, QPair<int, int>* first)
+{
+    for (const Move &move : moves) {
+        const int dense = m_typeOf[move.a];
+        if (move.order > kClearLimit || m_typeChecked[dense] == m_checkStamp) continue;
+        m_typeChecked[dense] = m_checkStamp;
+
+        QVector<int> &tiles = m_clearTiles;
+        tiles.clear();
+        for (int idx : std::as_const(m_tiles))
+            if (m_typeOf[idx] == dense && m_board.typeAt(idx) != -1) tiles.append(idx);
+        if (clearInOrder(tiles, first)) return true;
+    }
+    return false;
+}
+
+// 小规模回溯：tiles 中的箱子能否依次两两连通消完，成功时给出第一步
+bool BoardSolver::clearInOrder(QVector<int>& tiles, QPair<int, int>* first)
+{
+    if (tiles.isEmpty()) return true;
+
+    const int stride = m_board.stride();
+    const int n = tiles.size();
+    for (int i = 0; i < n; ++i) {
+        for (int j = i + 1; j < n; ++j) {
+            const int a = tiles[i], b = tiles[j];
+            if (!m_board.linkable(a, b)) continue;
+
+            const int type = m_board.typeAt(a);
+            m_board.set(a / stride, a % stride, -1);
+            m_board.set(b / stride, b % stride, -1);
+            QVector<int> rest;
+            for (int k = 0; k < n; ++k)
+                if (k != i && k != j) rest.append(tiles[k]);
+            const bool ok = clearInOrder(rest, nullptr);
+            m_board.set(a / stride, a % stride, type);
+            m_board.set(b / stride, b % stride, type);
+
+            if (ok) {
+                if (first) *first = qMakePair(a, b);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool BoardSolver::search(int remaining, quint64 hash, int depth)
+{
+    if (remaining == 0) return true;
+
+    ++m_result.nodes;
+    if (m_result.nodes > m_nodeLimit ||
+        ((m_result.nodes & 255) == 0 && m_timer.elapsed() > m_timeLimitMs)) {
+        m_aborted = true;
+        m_limitHit = true;
+        return false;
+    }
+    if (m_result.nodes > m_roundLimit) {
+        m_aborted = true;
+        return false;
+    }
+
+    const quint64 key = hash ^ m_tableSalt;
+    quint64 &slot = m_table[int(hash & m_tableMask)];
+    if (slot == key) {
+        ++m_result.tableHits;
+        return false;
+    }
+
+    QVector<Move> &moves = m_moveStack[depth];
+    generateMoves(moves);
+    if (++m_checkStamp == 0) {
+        m_typeChecked.fill(0);
+        m_checkStamp = 1;
+    }
+
+    if (moves.isEmpty()) {
+        slot = key;
+        return false;
+    }
+
+    // 某类型剩余的箱子现在就能按某种顺序全部消掉时，照此消除，不必分支：
+    // 任何解迟早要消完这些箱子，提前消除只会腾出更多空格，不会让其他配对变难
+    // 若这条消除顺序的第一步正在休眠，说明经过它的解都已被排除，局面必死
+    QPair<int, int> first;
+    if (findClearableType(moves, &first)) {
+        if (m_sleeping.contains(moveKey(first.first, first.second))) {
+            slot = key;
+            return false;
+        }
+        moves.clear();
+        moves.append({first.first, first.second, 0});
+    } else {
+        // 休眠集：祖先结点上已试过并失败的配对，在其兄弟子树中不必再试
+        // 消除只会腾出空格，若某解用到了它，把它提前到祖先处执行同样成立，与其失败矛盾
+        int kept = 0;
+        for (int i = 0; i < moves.size(); ++i) {
+            if (!m_sleeping.contains(moveKey(moves[i].a, moves[i].b)))
+                moves[kept++] = moves[i];
+        }
+        moves.resize(kept);
+        if (moves.isEmpty()) {
+            slot = key;
+            return false;
+        }
+
+        // 剩余数量少的类型分支少、更容易被堵死，优先尝试；重启轮次里同优先级的走法随机排列
+        if (m_shuffle) std::shuffle(moves.begin(), moves.end(), m_rng);
+        std::stable_sort(moves.begin(), moves.end(),
+                         [](const Move &x, const Move &y) { return x.order < y.order; });
+    }
+
+    const int stride = m_board.stride();
+    int slept = 0;
+    bool solved = false;
+    for (int i = 0; i < moves.size() && !solved && !m_aborted; ++i) {
+        const Move move = moves[i];
+        const int type = m_board.typeAt(move.a);
+        const int dense = m_typeOf[move.a];
+
+        m_board.set(move.a / stride, move.a % stride, -1);
+        m_board.set(move.b / stride, move.b % stride, -1);
+        m_typeLeft[dense] -= 2;
+        m_path.append(qMakePair(move.a, move.b));
+
+        solved = search(remaining - 2, hash ^ m_zobrist[move.a] ^ m_zobrist[move.b], depth + 1);
+        if (solved) break;
+
+        m_path.removeLast();
+        m_typeLeft[dense] += 2;
+        m_board.set(move.a / stride, move.a % stride, type);
+        m_board.set(move.b / stride, move.b % stride, type);
+
+        // 失败的配对进入休眠，后续兄弟子树跳过
+        const qint64 key = moveKey(move.a, move.b);
+        if (!m_sleeping.contains(key)) {
+            m_sleeping.insert(key);
+            m_sleepStack.append(key);
+            ++slept;
+        }
+    }
+
+    // 离开本结点时唤醒本层加入的配对
+    for (int i = 0; i < slept; ++i)
+        m_sleeping.remove(m_sleepStack.takeLast());
+
+    if (solved) return true;
+
+    // 只有完整搜索过的子树才能记为无解
+    if (!m_aborted) m_table[int(hash & m_tableMask)] = key;
+    return false;
+}
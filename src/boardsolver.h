@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QVector>
+#include <QPoint>
+#include <QPair>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QtGlobal>
+#include "boardgrid.h"
+#include <random>
+
+// BoardSolver 类：判断棋盘能否被完全消除
+// 在棋盘副本上对可消对做深度优先搜索，Zobrist 哈希 + 定长置换表记录已证明无解的局面
+class BoardSolver {
+public:
+    struct Result {
+        bool solvable = false;      // 找到了完整的消除顺序
+        bool finished = true;       // false 表示触及节点/时间上限，结论未知
+        qint64 nodes = 0;           // 展开的局面数
+        qint64 tableHits = 0;       // 置换表命中次数
+        int restarts = 0;           // 重启次数
+        qint64 elapsedUs = 0;       // 耗时（微秒）
+        QVector<QPair<QPoint, QPoint>> solution;    // 消除顺序，原map坐标 QPoint(col,row)
+    };
+
+    // tableBytes 为置换表内存上限，实际取不超过它的 2 的幂个表项
+    explicit BoardSolver(int tableBytes = 1 << 20);
+
+    // 搜索上限，任一触发即停止并返回 finished == false
+    void setNodeLimit(qint64 nodes) { m_nodeLimit = nodes; }
+    void setTimeLimit(int ms) { m_timeLimitMs = ms; }
+
+    Result solve(const BoardGrid& board);
+
+private:
+    struct Move { int a; int b; int order; };
+    static qint64 moveKey(int a, int b) { return (qint64(a) << 32) | b; }
+
+    // 剩余数量不超过该值的类型才检查能否立即全部消除（回溯量随数量急剧增长）
+    static const int kClearLimit = 6;
+    // 首轮节点预算，之后每次重启翻倍
+    static const int kFirstRoundNodes = 1000;
+
+    bool search(int remaining, quint64 hash, int depth);
+    void generateMoves(QVector<Move>& moves) const;
+    bool findClearableType(const QVector<Move>& moves, QPair<int, int>* first);
+    bool clearInOrder(QVector<int>& tiles, QPair<int, int>* first);
+
+    BoardGrid m_board;                  // 搜索用副本，消除/撤销直接改写
+    mutable BoardGrid::Reach m_reach;
+    QVector<int> m_tiles;               // 初始箱子所在格（padding 网格下标）
+    QVector<int> m_typeOf;              // 格子 -> 紧凑类型编号（-1 为空）
+    QVector<int> m_typeLeft;            // 每种类型剩余箱子数
+    QVector<quint64> m_zobrist;         // 每格一个随机键，局面哈希为剩余箱子键的异或
+    QVector<QVector<Move>> m_moveStack; // 每层深度一份走法缓冲，回溯时复用
+    QVector<int> m_typeChecked;         // 本结点已检查过的类型（与 m_checkStamp 比较）
+    int m_checkStamp = 0;
+    QVector<int> m_clearTiles;
+
+    QVector<quint64> m_table;           // 已证明无解的局面哈希（直接映射，冲突时覆盖），存的是 哈希^盐值
+    quint64 m_tableMask = 0;
+    quint64 m_generation = 0;           // 求解次数，每次求解换一个盐值，代替整表清零
+    quint64 m_tableSalt = 0;
+
+    QVector<QPair<int, int>> m_path;    // 当前搜索路径上的消除顺序
+    QSet<qint64> m_sleeping;            // 休眠集：祖先结点上已失败的配对
+    QVector<qint64> m_sleepStack;       // 休眠集的加入顺序，回溯时按层移除
+    QElapsedTimer m_timer;
+    qint64 m_nodeLimit = 2000000;
+    int m_timeLimitMs = 1000;
+    qint64 m_roundLimit = 0;            // 本轮节点上限
+    bool m_aborted = false;             // 本轮被中止（轮次预算或总上限）
+    bool m_limitHit = false;            // 触及总节点/时间上限
+    bool m_shuffle = false;
+    std::mt19937 m_rng;
+    Result m_result;
+};
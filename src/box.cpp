@@ -1,12 +1,16 @@
 #include "box.h"
+#include "spriteatlas.h"
+#include "boardlayer.h"
 #include <QPixmap>
 #include <QGraphicsScene>
 #include <QRandomGenerator>
-#include <QGraphicsDropShadowEffect>
+
+int Box::s_liveCount = 0;
 
 // 构造，传入位置、贴图路径、所要添加的scene
 Box::Box(const QPointF &pos, const QString &imagePath, QGraphicsScene *scene)
 {
+    ++s_liveCount;
     setupSprite(imagePath);
     setOffset(-pixmap().width()/2, -pixmap().height()/2); // 中心对齐
     setPos(pos);
@@ -30,6 +34,11 @@ Box::Box(const QString &imagePath, QGraphicsScene *scene, const QPointF& charact
     setupSprite(imagePath);
 }
 
+Box::~Box()
+{
+    --s_liveCount;
+}
+
 // 辅助随机构造函数
 QPointF Box::generateRandomPosition(const QRectF &sceneRect,const QPointF &characterPos) {
     QPointF boxPos;
@@ -40,87 +49,121 @@ QPointF Box::generateRandomPosition(const QRectF &sceneRect,const QPointF &chara
     return QPointF(boxPos);
 }
 
-// 设置spritesheet，传入图片地址和切割大小
-void Box::setupSprite(const QPixmap &imagePath, int frameSize){
-    // 精灵图参数：recipe
-    // const int cols = 10;   // 横向10个小图
-    // const int rows = 17;   // 纵向17个小图
-    // const int skipLast = 6; // 右下角6个为空
-
-    // 精灵图参数：ingridient
-    const int cols = 10;   // 横向10个小图
-    const int rows = 7;   // 纵向7个小图
-    const int skipLast = 8; // 右下角8个为空
+// 设置spritesheet，传入图片地址，随机取一帧（帧由 SpriteAtlas 预先切好并共享）
+void Box::setupSprite(const QString &imagePath){
+    SpriteAtlas &atlas = SpriteAtlas::instance();
+    const int totalFrames = atlas.frameCount(imagePath);   // 不包括右下角空位
+    if (totalFrames == 0) {
+        setSprite(QPixmap());
+        return;
+    }
 
-    // !!!生成随机帧索引 [0, totalFrames-1]，int转换为整数，不包括最后六个空位!!!
-    int totalFrames = cols * rows - skipLast;
+    // 生成随机帧索引 [0, totalFrames-1]
     int randomFrame = QRandomGenerator::global()->bounded(totalFrames);
+    setSprite(atlas.frame(imagePath, randomFrame));
+}
 
-    int row = randomFrame / cols;
-    int col = randomFrame % cols;
-
-    QRect sourceRect(col * frameSize, row * frameSize, frameSize, frameSize);
-
-    setPixmap(imagePath.copy(sourceRect));
-    setOffset(-frameSize/2, -frameSize/2); // 中心对齐（构造函数中已经实现，可选择性删去）
+void Box::setSprite(const QPixmap &sprite){
+    m_sprite = sprite;
+    updateLook();
+}
 
+// 普通状态直接用原贴图放大1.5倍；高亮状态换成图集里按显示倍率预渲染好的贴图（自带光晕/遮罩），
+// 不再挂 QGraphicsEffect，切换高亮不触发任何模糊计算
+void Box::updateLook(){
+    const bool preselected = m_preselectCount > 0;
+    const bool lit = m_active || m_hinted;
+    if (!lit && !preselected) {
+        setPixmap(m_sprite);
+        setScale(1.5);
+    } else {
+        const qreal scale = lit ? 2 : 1.5;
+        setPixmap(SpriteAtlas::instance().decorated(m_sprite, scale,
+                                                    lit ? glowColor() : QColor(), preselected));
+        setScale(1);
+    }
+    setOffset(-pixmap().width()/2, -pixmap().height()/2); // 中心对齐
 }
 
 // 预选效果
 void Box::preAct() {
-    // 如果已有遮罩则先删除
-    if (m_overlay) delete m_overlay;
-    // 创建新遮罩
-    m_overlay = new QGraphicsRectItem(this->boundingRect(), this);
-    m_overlay->setBrush(QColor(0, 0, 0, 120));  // 调整颜色和透明度
-    m_overlay->setPen(Qt::NoPen);  // 去掉边框
-    m_overlay->setZValue(-1);
-    m_overlay->setFlag(QGraphicsItem::ItemStacksBehindParent, true);
-
+    if (++m_preselectCount > 1) return;
+    if (layer) {
+        layer->setCellFlag(row, col, BoardLayer::Preselected, true);
+        return;
+    }
+    updateLook();
 }
 
 // 取消预选
 void Box::npreAct() {
-    if (m_overlay) {
-        // 保险起见先从父子关系里摘掉
-        m_overlay->setParentItem(nullptr);
-        delete m_overlay;
-        m_overlay = nullptr;
-
-        // 关键：无效化 + 重绘
-        if (auto eff = graphicsEffect()) {      // 若有发光效果，先让它重新抓取源图
-            eff->setEnabled(false);
-            eff->setEnabled(true);
-        }
-        update();                                // 申请重绘当前 Item
-        if (scene())                             // 再保险一点：让场景也重绘此区域
-            scene()->invalidate(sceneBoundingRect(), QGraphicsScene::AllLayers);
+    if (m_preselectCount == 0 || --m_preselectCount > 0) return;
+    if (layer) {
+        layer->setCellFlag(row, col, BoardLayer::Preselected, false);
+        return;
     }
+    updateLook();
 }
 
 // 默认颜色的激活效果
 void Box::activate(){
-    this->setScale(2);
-    auto* glow = new QGraphicsDropShadowEffect;
-    glow->setColor(Qt::yellow);    // 金色发光
-    glow->setBlurRadius(20);        // 光晕大小
-    glow->setOffset(0);             // 居中发光
-    this->setGraphicsEffect(glow);  // 应用特效
+    activate(QColor(Qt::yellow).rgb());     // 金色发光
 }
 
 // 重载，传入颜色的激活效果
 void Box::activate(int colour){
-    this->setScale(2);
-    auto* glow = new QGraphicsDropShadowEffect;
-    glow->setColor(colour);    // 自定义发光颜色
-    glow->setBlurRadius(20);        // 光晕大小
-    glow->setOffset(0);             // 居中发光
-    this->setGraphicsEffect(glow);  // 应用特效
+    const QColor glow = QColor(QRgb(colour));
+    if (layer) {
+        m_active = true;
+        m_glow = glow;
+        layer->setCellGlow(row, col, glow);
+        layer->setCellFlag(row, col, BoardLayer::Selected, true);
+        return;
+    }
+    if (m_active && m_glow == glow) return;
+    m_active = true;
+    m_glow = glow;
+    updateLook();
 }
 
-// 取消激活
+// 取消激活（只取消玩家选中，提示高亮由 hint(false) 单独取消）
 void Box::deactivate(){
-    this->setScale(1.5);
-    // 移除发光效果
-    this->setGraphicsEffect(nullptr);
+    if (layer) {
+        m_active = false;
+        layer->setCellGlow(row, col, glowColor());
+        layer->setCellFlag(row, col, BoardLayer::Selected, false);
+        return;
+    }
+    if (!m_active) return;
+    m_active = false;
+    updateLook();
+}
+
+// 提示高亮：单独记一个状态位，与玩家选中叠加显示，开关提示不影响选中
+void Box::hint(bool on){
+    if (m_hinted == on) return;
+    m_hinted = on;
+    if (!layer) {
+        updateLook();
+        return;
+    }
+    layer->setCellGlow(row, col, glowColor());
+    layer->setCellFlag(row, col, BoardLayer::Hinted, on);
+}
+
+// 发光颜色：选中时用玩家的颜色，只有提示时用金色
+QColor Box::glowColor() const{
+    return m_active ? m_glow : QColor(Qt::yellow);
+}
+
+// 图层改写格子类型时会清掉该格状态（如洗牌），箱子换到新格后由它把自己的状态写回去
+void Box::syncLayer(){
+    if (!layer) {
+        updateLook();
+        return;
+    }
+    layer->setCellGlow(row, col, glowColor());
+    layer->setCellFlag(row, col, BoardLayer::Selected, m_active);
+    layer->setCellFlag(row, col, BoardLayer::Preselected, m_preselectCount > 0);
+    layer->setCellFlag(row, col, BoardLayer::Hinted, m_hinted);
 }
@@ -4,29 +4,48 @@
 #include<QObject>
 
 class Character;
+class BoardLayer;
 class Box : public QGraphicsPixmapItem
 {
 public:
     //初始化，explicit防止隐式类型转换，QString是Qt的字符类型
     explicit Box(const QPointF &pos, const QString &imagePath, QGraphicsScene *scene);
     explicit Box(const QString &imagePath, QGraphicsScene *scene, const QPointF& characterPos);
+    ~Box() override;
+
+    // 当前存活的 Box 数（含道具），内存统计用
+    static int liveCount() { return s_liveCount; }
+
     const qreal boxSize = 45;//用于碰撞检测的距离
     int boxType = 0;//0空，1-164为类型
     int toolType = 0;//对于道具类箱子的类型管理，1为+s
     int row;
     int col;
 
-    Character* preSelectedBy = nullptr;
+    Character* preSelectedBy = nullptr;     // 最近一次预选它的角色
+
+    // 批量绘制模式下由图层代画，Box 本身隐藏，只作为逻辑句柄（位置、碰撞、状态）
+    BoardLayer* layer = nullptr;
 
     void activate();
     void activate(int colour);
     void deactivate();
-    void preAct();
+    void preAct();          // 预选/取消预选按角色计数，双人同时靠近时一人离开不影响另一人
     void npreAct();
+    void hint(bool on);     // 提示道具高亮（与玩家选中互不覆盖）
+    void syncLayer();       // 按自身状态重画：图层模式写回所在格的状态位（换格、开关图层后调用）
+    void setSprite(const QPixmap &sprite);  // 更换贴图（保留当前的高亮状态）
 private:
-    void setupSprite(const QPixmap &imagePath, int frameSize = 26);//帧大小
+    static int s_liveCount;
+    void setupSprite(const QString &imagePath);//帧几何来自图集元数据
+    void updateLook();      // 按状态换上原贴图或图集里预渲染好的高亮贴图
+    QColor glowColor() const;   // 选中或提示时的发光颜色
     QPointF generateRandomPosition(const QRectF &sceneRect,const QPointF &characterPos);//随机位置辅助构造函数
-    QGraphicsRectItem* m_overlay = nullptr;  // 成员变量存储遮罩，用于预选中效果
+    QPixmap m_sprite;               // 原始贴图（未放大、无特效）
+    bool m_active = false;          // 玩家选中：放大 + 发光
+    int m_preselectCount = 0;       // 当前靠近它的角色数，>0 时垫一层黑色遮罩
+    bool m_hinted = false;          // 提示道具高亮：外观同选中，两者互不覆盖
+    QColor m_glow = Qt::yellow;
     bool debugMarkerEnabled = false;    // debug用坐标小圆点
 };
 
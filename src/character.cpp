@@ -5,22 +5,25 @@
 #include "collision.h"
 #include "powerupmanager.h"
 #include "mainwindow.h"
+#include "spriteatlas.h"
+#include "profiler.h"
 
 #include <cmath>
 #include <limits>
 
+int Character::s_liveCount = 0;
+
 // 构造函数，传入未裁切的spritesheet的文件路径
 Character::Character(const QString& spritePath, const QPointF& mapPixSize, QObject* parent)
     : QObject(parent), QGraphicsPixmapItem(),
     isPaused(false), isMoving(false), currentDirection(0), currentFrame(0),
-    movementTimer(new QTimer(this)), // 直接创建
-    animationTimer(new QTimer(this)), // 直接创建
     gameMap(nullptr),
     mapPixSize(mapPixSize),
-    characterScore(new Score(this))
+    characterScore(new Score(this)),
+    spritePath(spritePath)
 {
-    spriteSheet.load(spritePath);
-    if (spriteSheet.isNull()) {
+    ++s_liveCount;
+    if (SpriteAtlas::instance().frameCount(spritePath) == 0) {
         qWarning() << "Failed to load sprite:" << spritePath;
     }
 
@@ -28,13 +31,7 @@ Character::Character(const QString& spritePath, const QPointF& mapPixSize, QObje
     updateCharacterSprite();
     setZValue(2);
 
-    // 运动30帧
-    connect(movementTimer, &QTimer::timeout, this, &Character::updateMovement);
-    movementTimer->start(33);
-
-    // 动画5帧
-    connect(animationTimer, &QTimer::timeout, this, &Character::updateAnimation);
-    animationTimer->start(200);
+    // 移动与动画由 GameLoop 统一推进，见 step()
 
     characterScore->setPos(-45, -50);       // 位置调整为角色头顶偏移，具体由score类管理
 
@@ -51,32 +48,51 @@ Character::Character(const QString& spritePath, const QPointF& mapPixSize, QObje
 
 // 析构
 Character::~Character() {
+    --s_liveCount;
     qDebug() << "Character destructor called - safe mode";
     // Qt 自动管理
 }
 
+// 撤掉自己加在预选目标上的遮罩（目标可能已被消除，先确认仍在地图上）
+void Character::clearPreselection(){
+    if (preSelectedBox && gameMap && gameMap->m_boxes.contains(preSelectedBox)) {
+        preSelectedBox->npreAct();
+        if (preSelectedBox->preSelectedBy == this) preSelectedBox->preSelectedBy = nullptr;
+    }
+    preSelectedBox = nullptr;
+}
+
+// 箱子即将被删除：只清指针，不碰箱子本身（遮罩随箱子一起消失）
+void Character::forgetBox(Box* box){
+    if (!box) return;
+    if (lastActivatedBox == box) lastActivatedBox = nullptr;
+    if (preSelectedBox == box) preSelectedBox = nullptr;
+}
+
 // 传入map对象到character成员gamemap
 void Character::setGameMap(Map* map){
+    if (map != gameMap) preSelectedBox = nullptr;   // 旧地图可能已释放，不再回头撤遮罩
     gameMap = map;
     // 如果地图为空，停止移动避免崩溃
     if (!gameMap) {
         stopMoving();
-        // 确保定时器也停止
-        if (movementTimer) movementTimer->stop();
-        if (animationTimer) animationTimer->stop();
     }
 }
 
-// 对传入的spritesheet根据当前方向和帧进行裁切
-void Character::updateCharacterSprite() {
-    if (spriteSheet.isNull()) return;
+// 由 GameLoop 每个固定步长调用一次：移动每步一次（30帧），走路动画每 200ms 换一帧（5帧）
+void Character::step(int dtMs) {
+    updateMovement();
+    for (int n = animationCadence.advance(dtMs); n > 0; --n)
+        updateAnimation();
+}
 
-    QRect sourceRect(
-        currentDirection * frameWidth,
-        currentFrame * frameHeight,
-        frameWidth, frameHeight);
+// 根据当前方向和帧从图集取贴图：列为方向，行为动画帧
+void Character::updateCharacterSprite() {
+    SpriteAtlas &atlas = SpriteAtlas::instance();
+    const QPixmap frame = atlas.frame(spritePath, currentFrame * atlas.columns(spritePath) + currentDirection);
+    if (frame.isNull()) return;
 
-    setPixmap(spriteSheet.copy(sourceRect));
+    setPixmap(frame);
 }
 
 // 开始运动，传入int类方向0-3代表上左右下
@@ -100,32 +116,32 @@ void Character::stopMoving() {
     updateCharacterSprite();
 }
 
-// 更新运动状态，30帧，movementTimer的slot
+// 更新运动状态，每个固定步长一次
 void Character::updateMovement() {
     if (!isMoving || isPaused || !gameMap) return; // 检查 gameMap 是否存在
+    PROFILE_SCOPE("movement");
 
     // characterScore->setZValue(150);
 
     QPointF newPos = pos() + moveDirection * moveSpeed;
     bool willCollide = false;
     Box* nearestBox = nullptr;
-    qreal nearestDist = std::numeric_limits<qreal>::max();
+    qreal nearestDist2 = std::numeric_limits<qreal>::max();
 
     if (gameMap) {
-        // 遍历所有 Box
-        for (Box* box : gameMap->m_boxes) {
-            // 碰撞检测
-            if (Collision::willCollide(pos(), moveDirection, moveSpeed, box, box->boxSize)) {
-                willCollide = true;
-                emit collidedWithBox(box, this);    // 声明事件发生,通知 MainWindow
-                break;
-            }
-
-            // 距离检测，找最近的
-            QPointF del = Collision::getDistance(pos(), box->pos());
-            qreal dist = Collision::EuclidDistance(del);
-            if (dist < nearestDist) {
-                nearestDist = dist;
+        PROFILE_SCOPE("collision");
+
+        // 只看角色所在格子周围 3x3 的箱子，每 tick 的开销与棋盘大小无关
+        gameMap->boxesNear(pos(), nearBoxes);
+
+        // 碰撞检测，并按距离平方找最近的
+        Box* collided = nullptr;
+        for (Box* box : std::as_const(nearBoxes)) {
+            if (!collided && Collision::willCollide(pos(), moveDirection, moveSpeed, box, box->boxSize))
+                collided = box;
+            const qreal dist2 = Collision::squaredDistance(pos(), box->pos());
+            if (dist2 < nearestDist2) {
+                nearestDist2 = dist2;
                 nearestBox = box;
             }
         }
@@ -135,21 +151,30 @@ void Character::updateMovement() {
             setZValue(pos().y() > ( nearestBox->pos().y() - gameMap->getSpacing() / 2 ) ? 2 : 0);
         }
 
-        // 最近 Box 高亮与黑色遮罩，每个效果各自记录对应的 character 对象，故而双人模式下消除逻辑不会影响另一个 character
-        for (Box* box : gameMap->m_boxes) {
-            if (box == nearestBox && nearestDist < frameWidth * 0.75){
-                box->preSelectedBy = this;
-                box->preAct();
-            }else if (box->preSelectedBy == this) {
-                box->npreAct();
-                box->preSelectedBy = nullptr;
+        // 最近 Box 的黑色遮罩：只在预选目标变化时撤旧加新，站着不动时不改动任何图元
+        // Box 按角色计数，双人模式下一人离开不会撤掉另一人的遮罩
+        const qreal preselectRange = frameWidth * 0.75;
+        Box* target = (nearestBox && nearestDist2 < preselectRange * preselectRange) ? nearestBox : nullptr;
+        if (target != preSelectedBox) {
+            clearPreselection();
+            if (target) {
+                target->preSelectedBy = this;
+                target->preAct();
             }
+            preSelectedBox = target;
+        }
+
+        // 最后再通知 MainWindow：处理消除时可能删掉附近的箱子，之后不再访问它们
+        if (collided) {
+            willCollide = true;
+            emit collidedWithBox(collided, this);    // 声明事件发生,通知 MainWindow
         }
     }
 
     if (gameMap) {
-        // 遍历所以tools
-        for (Box* box : gameMap->m_tools){
+        // 附近的道具
+        gameMap->toolsNear(pos(), nearTools);
+        for (Box* box : std::as_const(nearTools)){
             // 碰撞检测
             if (Collision::willCollide(pos(), moveDirection, moveSpeed, box, box->boxSize)) {
                 // willCollide = true;
@@ -174,7 +199,7 @@ void Character::updateMovement() {
     setPos(x, y);
 }
 
-// 更新动画，5帧，animationTimer的slot，实现01020102...走路动画
+// 更新动画，每 200ms 一次，实现01020102...走路动画
 void Character::updateAnimation() {
     if (!isMoving || isPaused) return;;
 
@@ -227,20 +252,3 @@ void Character::handleKeyRelease(QKeyEvent* event) {
         stopMoving();
     }
 }
-
-// 辅助析构函数，停止和disconnect移动和动作两个计时器
-void Character::stopTimers() {
-    qDebug() << "Stopping character timers safely";
-    if (movementTimer) {
-        movementTimer->stop();
-        disconnect(movementTimer, nullptr, this, nullptr);
-        movementTimer->deleteLater(); // 使用 deleteLater 而不是立即删除
-        movementTimer = nullptr;
-    }
-    if (animationTimer) {
-        animationTimer->stop();
-        disconnect(animationTimer, nullptr, this, nullptr);
-        animationTimer->deleteLater(); // 使用 deleteLater 而不是立即删除
-        animationTimer = nullptr;
-    }
-}
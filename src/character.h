@@ -1,10 +1,11 @@
 #pragma once
 
 #include <QGraphicsPixmapItem>
-#include <QTimer>
 #include <QPointF>
 #include <QPixmap>
 #include <QKeyEvent>
+#include <QVector>
+#include "gameloop.h"
 
 // 前向声明，避免循环包含
 class Box;
@@ -28,6 +29,9 @@ public:
     Character(const QString& spritePath, const QPointF& mapPixSize, QObject* parent = nullptr);
     ~Character();
 
+    // 当前存活的角色数，内存统计用
+    static int liveCount() { return s_liveCount; }
+
     void setControls(const ControlScheme& scheme) { controls = scheme; }
     void setGameMap(Map* map);
     Score* getCharacterScore() const { return characterScore; }
@@ -36,12 +40,14 @@ public:
 
     void handleKeyPress(QKeyEvent* event);
     void handleKeyRelease(QKeyEvent* event);
-    void stopTimers();
+    void step(int dtMs);        // 由 GameLoop 每个固定步长调用
     bool isPaused;
 
     Box* getLastActivatedBox() const { return lastActivatedBox; }
     void setLastActivatedBox(Box* box) { lastActivatedBox = box; }
     void clearLastActivatedBox() { lastActivatedBox = nullptr; }
+    // 箱子即将被删除：丢掉对它的全部引用（选中、预选），之后不再访问它
+    void forgetBox(Box* box);
 
 signals:
     void collidedWithBox(Box* box, Character* sender);  // sender参数,碰撞时发射信号，交给 MainWindow 处理
@@ -54,6 +60,7 @@ private:
     void updateCharacterSprite();
     void startMoving(int direction);
     void stopMoving();
+    void clearPreselection();
 
     // 控制配置
     ControlScheme controls;
@@ -68,11 +75,9 @@ private:
     int currentFrame;        // 0=静止, 1=左脚, 2=右脚
     const int frameWidth = 64;
     const int frameHeight = 64;
-    QPixmap spriteSheet;
 
-    // 计时器
-    QTimer* movementTimer;
-    QTimer* animationTimer;
+    // 走路动画按游戏时间换帧
+    Cadence animationCadence{200};
 
     // 地图引用（用于碰撞检测）
     Map* gameMap = nullptr;
@@ -81,9 +86,21 @@ private:
     // 分数对象指针
     Score* characterScore;
 
+    // 精灵图路径（帧由 SpriteAtlas 统一切好并共享）
+    QString spritePath;
+
+    static int s_liveCount;
+
     // 每个角色自己的最后激活盒子
     Box* lastActivatedBox = nullptr;
 
+    // 当前由自己加了预选遮罩的盒子（只在目标变化时更新）
+    Box* preSelectedBox = nullptr;
+
+    // 附近箱子/道具的查询缓冲，每 tick 复用
+    QVector<Box*> nearBoxes;
+    QVector<Box*> nearTools;
+
     // debug用坐标小圆点
     bool debugMarkerEnabled = false;
     QGraphicsEllipseItem* roleMarker = nullptr;
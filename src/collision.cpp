@@ -31,3 +31,8 @@ qreal Collision::EuclidDistance(const QPointF& pos1, const QPointF& pos2){
     QPointF dis = getDistance(pos1, pos2);
     return (sqrt(dis.x() * dis.x() + dis.y() * dis.y()));
 }
+
+qreal Collision::squaredDistance(const QPointF& pos1, const QPointF& pos2){
+    QPointF dis = getDistance(pos1, pos2);
+    return dis.x() * dis.x() + dis.y() * dis.y();
+}
@@ -19,5 +19,7 @@ public:
     // 获取两个物体中心点之间的距离
     static QPointF getDistance(const QPointF& pos1, const QPointF& pos2);
     static qreal EuclidDistance(const QPointF& pos1, const QPointF& pos2 = QPointF(0, 0));
+    // 距离的平方，只比较远近时用，省去开方
+    static qreal squaredDistance(const QPointF& pos1, const QPointF& pos2);
 };
 
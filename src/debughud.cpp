@@ -0,0 +1,77 @@
+#include "debughud.h"
+#include "profiler.h"
+#include <QCoreApplication>
+#include <QPainter>
+#include <QFont>
+#include <QEvent>
+
+DebugHud::DebugHud(QGraphicsItem* parent)
+    : QGraphicsTextItem(parent)
+{
+    setDefaultTextColor(Qt::white);
+    setFont(QFont("Consolas", 10));
+    setZValue(200);
+    setPos(20, 60);
+    m_sinceRefresh.start();
+    if (isVisible()) QCoreApplication::instance()->installEventFilter(this);
+}
+
+DebugHud::~DebugHud()
+{
+    QCoreApplication::instance()->removeEventFilter(this);
+}
+
+// 显示时才在应用上挂事件过滤器统计定时器唤醒
+QVariant DebugHud::itemChange(GraphicsItemChange change, const QVariant& value)
+{
+    if (change == ItemVisibleHasChanged) {
+        if (value.toBool()) {
+            QCoreApplication::instance()->installEventFilter(this);
+            m_timerEvents = 0;
+            m_sinceRefresh.start();
+        } else {
+            QCoreApplication::instance()->removeEventFilter(this);
+        }
+    }
+    return QGraphicsTextItem::itemChange(change, value);
+}
+
+bool DebugHud::eventFilter(QObject* watched, QEvent* event)
+{
+    if (event->type() == QEvent::Timer) ++m_timerEvents;
+    return QGraphicsTextItem::eventFilter(watched, event);
+}
+
+void DebugHud::refresh(const QVector<QPair<QString, int>>& counts, const QStringList& extra)
+{
+    const qint64 elapsed = m_sinceRefresh.restart();
+    if (elapsed > 0) m_wakeupsPerSecond = m_timerEvents * 1000.0 / elapsed;
+    m_timerEvents = 0;
+
+    QStringList lines;
+    const Profiler &profiler = Profiler::instance();
+    if (!Profiler::isEnabled()) lines << "profiling disabled in this build";
+    for (int i = 0; i < profiler.sectionCount(); ++i) {
+        const Profiler::Stats s = profiler.stats(i);
+        lines << QString("%1 %2ms  max %3ms")
+                     .arg(profiler.sectionName(i), -10)
+                     .arg(s.meanMs, 7, 'f', 3)
+                     .arg(s.maxMs, 7, 'f', 3);
+    }
+    lines << QString("timer wakeups %1/s").arg(m_wakeupsPerSecond, 0, 'f', 1);
+
+    QStringList countLine;
+    for (const QPair<QString, int>& count : counts)
+        countLine << QString("%1 %2").arg(count.first).arg(count.second);
+    if (!countLine.isEmpty()) lines << countLine.join("  ");
+    lines << extra;
+
+    setPlainText(lines.join('\n'));
+}
+
+// 半透明底色，叠在棋盘上也看得清
+void DebugHud::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    painter->fillRect(boundingRect(), QColor(0, 0, 0, 160));
+    QGraphicsTextItem::paint(painter, option, widget);
+}
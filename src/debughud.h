@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QGraphicsTextItem>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+
+// DebugHud 类：场景里可开关的调试面板
+// 显示各分节（帧间隔、重绘、tick 及其中的移动/碰撞/可消性/提示等）的滚动耗时、
+// 每秒事件循环定时器唤醒次数以及调用方提供的计数与内存统计；只在显示时统计唤醒，隐藏时不占开销
+class DebugHud : public QGraphicsTextItem {
+public:
+    explicit DebugHud(QGraphicsItem* parent = nullptr);
+    ~DebugHud();
+
+    // 刷新文字，counts 为调用方提供的额外计数（箱子、道具、角色等），extra 为附加的整行文字（如内存统计）
+    void refresh(const QVector<QPair<QString, int>>& counts, const QStringList& extra = QStringList());
+
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+
+protected:
+    QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    int m_timerEvents = 0;          // 上次刷新以来的定时器事件数
+    QElapsedTimer m_sinceRefresh;
+    double m_wakeupsPerSecond = 0;
+};
@@ -0,0 +1,88 @@
+#include "effectpool.h"
+#include <QGraphicsScene>
+#include <QGraphicsPathItem>
+#include <QGraphicsTextItem>
+#include <QPainterPath>
+#include <QPen>
+#include <QFont>
+
+EffectPool::EffectPool(QGraphicsScene* scene, int prealloc)
+    : m_scene(scene)
+{
+    for (int i = 0; i < prealloc; ++i) {
+        m_idlePaths.append(createPath());
+        m_idleTexts.append(createText());
+    }
+}
+
+EffectPool::~EffectPool()
+{
+    for (QGraphicsPathItem* item : m_paths) {
+        if (item->scene()) item->scene()->removeItem(item);
+        delete item;
+    }
+    for (QGraphicsTextItem* item : m_texts) {
+        if (item->scene()) item->scene()->removeItem(item);
+        delete item;
+    }
+}
+
+// 连线样式固定，创建时一次设好
+QGraphicsPathItem* EffectPool::createPath()
+{
+    QPen pen(QColor(155, 123, 128), 10);
+    pen.setJoinStyle(Qt::RoundJoin);
+    pen.setCapStyle(Qt::RoundCap);
+
+    QGraphicsPathItem* item = new QGraphicsPathItem();
+    item->setPen(pen);
+    item->setZValue(-1);
+    item->setVisible(false);
+    if (m_scene) m_scene->addItem(item);
+    m_paths.append(item);
+    return item;
+}
+
+// 反馈文字字体固定，创建时一次设好
+QGraphicsTextItem* EffectPool::createText()
+{
+    QGraphicsTextItem* item = new QGraphicsTextItem();
+    item->setFont(QFont("Consolas", 16, QFont::Bold));
+    item->setZValue(100);
+    item->setVisible(false);
+    if (m_scene) m_scene->addItem(item);
+    m_texts.append(item);
+    return item;
+}
+
+QGraphicsPathItem* EffectPool::showPath(const QPainterPath& path)
+{
+    QGraphicsPathItem* item = m_idlePaths.isEmpty() ? createPath() : m_idlePaths.takeLast();
+    item->setPath(path);
+    item->setVisible(true);
+    return item;
+}
+
+QGraphicsTextItem* EffectPool::showText(const QString& text, const QColor& color, const QPointF& position)
+{
+    QGraphicsTextItem* item = m_idleTexts.isEmpty() ? createText() : m_idleTexts.takeLast();
+    if (item->toPlainText() != text) item->setPlainText(text);
+    item->setDefaultTextColor(color);
+    item->setPos(position);
+    item->setVisible(true);
+    return item;
+}
+
+void EffectPool::release(QGraphicsPathItem* item)
+{
+    if (!item || !item->isVisible()) return;
+    item->setVisible(false);
+    m_idlePaths.append(item);
+}
+
+void EffectPool::release(QGraphicsTextItem* item)
+{
+    if (!item || !item->isVisible()) return;
+    item->setVisible(false);
+    m_idleTexts.append(item);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QVector>
+#include <QColor>
+#include <QPointF>
+#include <QString>
+
+class QGraphicsScene;
+class QGraphicsPathItem;
+class QGraphicsTextItem;
+class QPainterPath;
+
+// EffectPool 类：一局内反复出现的短时图元（连线、反馈文字）的回收池
+// 图元创建后一直留在场景里，空闲时隐藏；取用时只改路径、文字、颜色和位置，
+// 画笔和字体在创建时设好，连击时不再反复 new/delete 图元、加入/移出场景
+class EffectPool {
+public:
+    // 预先为每种图元建好 prealloc 个
+    explicit EffectPool(QGraphicsScene* scene, int prealloc = 4);
+    // 从场景移除并删除池中全部图元（包括正在显示的）
+    ~EffectPool();
+
+    // 取一个空闲图元显示出来，没有空闲的才新建
+    QGraphicsPathItem* showPath(const QPainterPath& path);
+    QGraphicsTextItem* showText(const QString& text, const QColor& color, const QPointF& position);
+
+    // 用完归还：隐藏并放回空闲表
+    void release(QGraphicsPathItem* item);
+    void release(QGraphicsTextItem* item);
+
+    // 池中图元总数与空闲数（用于检查是否真的复用）
+    int pathCount() const { return m_paths.size(); }
+    int textCount() const { return m_texts.size(); }
+    int idlePathCount() const { return m_idlePaths.size(); }
+    int idleTextCount() const { return m_idleTexts.size(); }
+
+private:
+    QGraphicsPathItem* createPath();
+    QGraphicsTextItem* createText();
+
+    QGraphicsScene* m_scene;
+    QVector<QGraphicsPathItem*> m_paths;        // 全部连线图元
+    QVector<QGraphicsPathItem*> m_idlePaths;    // 空闲（已隐藏）的连线图元
+    QVector<QGraphicsTextItem*> m_texts;
+    QVector<QGraphicsTextItem*> m_idleTexts;
+};
@@ -0,0 +1,32 @@
+#include "gameclock.h"
+
+GameClock::GameClock()
+{
+    m_wall.start();
+}
+
+qint64 GameClock::nowNs() const
+{
+    if (m_paused) return m_baseNs;
+    return m_baseNs + qint64(m_wall.nsecsElapsed() * m_scale);
+}
+
+// 把到目前为止经过的时间结算进 m_baseNs，真实时间重新从 0 计
+void GameClock::rebase()
+{
+    m_baseNs = nowNs();
+    m_wall.restart();
+}
+
+void GameClock::setTimeScale(double scale)
+{
+    rebase();
+    m_scale = qMax(0.0, scale);
+}
+
+void GameClock::setPaused(bool paused)
+{
+    if (paused == m_paused) return;
+    rebase();
+    m_paused = paused;
+}
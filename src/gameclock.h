@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+// GameClock 类：游戏时间来源，可暂停、单步、按倍率加速
+// 默认跟随真实时间（倍率1）；GameLoop 每次唤醒向它取当前游戏时间，所有计时行为都以它为准，
+// 暂停时游戏时间冻结，手动 advance() 可在暂停状态下单步推进
+class GameClock {
+public:
+    GameClock();
+
+    // 当前游戏时间（ns），单调不减
+    qint64 nowNs() const;
+    qint64 nowMs() const { return nowNs() / 1000000; }
+
+    // 真实时间 -> 游戏时间的倍率（如 100 表示 100 倍速），修改前经过的时间按旧倍率结算
+    void setTimeScale(double scale);
+    double timeScale() const { return m_scale; }
+
+    void setPaused(bool paused);
+    bool isPaused() const { return m_paused; }
+
+    // 手动推进游戏时间（暂停时用于单步）
+    void advance(qint64 ms) { m_baseNs += ms * 1000000; }
+
+private:
+    void rebase();
+
+    QElapsedTimer m_wall;
+    qint64 m_baseNs = 0;        // 上次结算时的游戏时间
+    double m_scale = 1.0;
+    bool m_paused = false;
+};
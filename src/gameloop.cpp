@@ -0,0 +1,88 @@
+#include "gameloop.h"
+#include <QtMath>
+
+GameLoop::GameLoop(int stepMs, QObject* parent)
+    : QObject(parent),
+    m_stepMs(qMax(1, stepMs))
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setInterval(m_stepMs);
+    connect(&m_timer, &QTimer::timeout, this, &GameLoop::onWakeup);
+}
+
+void GameLoop::setClock(GameClock* clock)
+{
+    m_clock = clock ? clock : &m_ownClock;
+    m_lastNs = m_clock->nowNs();
+}
+
+void GameLoop::start()
+{
+    if (m_timer.isActive()) return;
+    m_wall.start();
+    m_lastNs = m_clock->nowNs();
+    m_accumNs = 0;
+    m_timer.start();
+}
+
+void GameLoop::stop()
+{
+    m_timer.stop();
+    m_stopRequested = true;
+}
+
+// 记录真实唤醒间隔的抖动，再从时钟取经过的游戏时间，按固定步长走完
+void GameLoop::onWakeup()
+{
+    const double wallMs = m_wall.nsecsElapsed() / 1e6;
+    m_wall.restart();
+    const double jitterMs = qAbs(wallMs - m_stepMs);
+    ++m_jitterSamples;
+    m_jitterSumMs += jitterMs;
+    m_jitterMaxMs = qMax(m_jitterMaxMs, jitterMs);
+
+    const qint64 now = m_clock->nowNs();
+    const qint64 delta = now - m_lastNs;
+    m_lastNs = now;
+
+    const qint64 stepNs = qint64(m_stepMs) * 1000000;
+    const int maxSteps = kMaxCatchUpSteps * qMax(1, qCeil(m_clock->timeScale()));
+    m_accumNs += delta;
+    int steps = 0;
+    while (m_accumNs >= stepNs && steps < maxSteps) {
+        m_accumNs -= stepNs;
+        ++steps;
+        ++m_ticks;
+        emit tick(m_stepMs);
+        if (!m_timer.isActive()) return;    // tick 里结束了本局
+    }
+    if (m_accumNs >= stepNs) m_accumNs %= stepNs;
+}
+
+int GameLoop::runSteps(int n)
+{
+    m_stopRequested = false;
+    int steps = 0;
+    while (steps < n && !m_stopRequested) {    // tick 里调用 stop()（如本局结束）则提前返回
+        ++steps;
+        ++m_ticks;
+        emit tick(m_stepMs);
+    }
+    return steps;
+}
+
+GameLoop::Jitter GameLoop::jitter() const
+{
+    Jitter j;
+    j.samples = m_jitterSamples;
+    j.meanMs = m_jitterSamples ? m_jitterSumMs / m_jitterSamples : 0;
+    j.maxMs = m_jitterMaxMs;
+    return j;
+}
+
+void GameLoop::resetJitter()
+{
+    m_jitterSamples = 0;
+    m_jitterSumMs = 0;
+    m_jitterMaxMs = 0;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QtGlobal>
+#include "gameclock.h"
+
+// 按游戏时间累积的周期计数：advance() 返回这一步跨过了几个周期（各系统用它代替自己的 QTimer）
+struct Cadence {
+    explicit Cadence(int periodMs) : periodMs(periodMs) {}
+
+    int advance(int dtMs) {
+        accumMs += dtMs;
+        const int n = accumMs / periodMs;
+        accumMs -= n * periodMs;
+        return n;
+    }
+    void reset() { accumMs = 0; }
+
+    int periodMs;
+    int accumMs = 0;
+};
+
+// GameLoop 类：一局游戏唯一的时钟，以固定步长推进所有角色与系统
+// 只用一个 QTimer 唤醒；每次唤醒从 GameClock 取经过的游戏时间并累积，按固定步长补足应走的 tick，
+// 所以各系统之间不会互相漂移。画面仍由场景自行合并刷新，与模拟走了几步无关
+// 时钟可注入：暂停/加速由 GameClock 决定；无界面模拟可不启动定时器，直接 runFor() 尽快跑完
+class GameLoop : public QObject
+{
+    Q_OBJECT
+public:
+    explicit GameLoop(int stepMs = 33, QObject* parent = nullptr);
+
+    // 使用外部时钟（不转移所有权，需比 GameLoop 活得久），nullptr 恢复内部的真实时间时钟
+    void setClock(GameClock* clock);
+    GameClock* clock() const { return m_clock; }
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_timer.isActive(); }
+
+    // 不等真实时间，立即连续推进 n 步 / 至少 ms 毫秒的游戏时间（无界面模拟、测试用），返回实际步数
+    int runSteps(int n);
+    int runFor(qint64 ms) { return runSteps(int((ms + m_stepMs - 1) / m_stepMs)); }
+
+    int stepMs() const { return m_stepMs; }
+    qint64 tickCount() const { return m_ticks; }
+    qint64 elapsedMs() const { return m_ticks * m_stepMs; }     // 已模拟的游戏时间
+
+    // 唤醒抖动：相邻两次唤醒的实际间隔与标称步长之差的绝对值
+    struct Jitter {
+        qint64 samples = 0;
+        double meanMs = 0;
+        double maxMs = 0;
+    };
+    Jitter jitter() const;
+    void resetJitter();
+
+signals:
+    void tick(int stepMs);      // 每个固定步长发一次，所有系统在这里推进
+
+private slots:
+    void onWakeup();
+
+private:
+    // 单次唤醒最多补的步数（按时钟倍率放大），卡顿过久时丢弃多余的时间，避免越追越慢
+    static constexpr int kMaxCatchUpSteps = 5;
+
+    const int m_stepMs;
+    QTimer m_timer;
+    GameClock m_ownClock;
+    GameClock* m_clock = &m_ownClock;
+    QElapsedTimer m_wall;       // 真实唤醒间隔，只用于统计抖动
+    qint64 m_lastNs = 0;
+    qint64 m_accumNs = 0;
+    qint64 m_ticks = 0;
+    bool m_stopRequested = false;
+
+    qint64 m_jitterSamples = 0;
+    double m_jitterSumMs = 0;
+    double m_jitterMaxMs = 0;
+};
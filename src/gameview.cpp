@@ -0,0 +1,17 @@
+#include "gameview.h"
+#include "profiler.h"
+
+GameView::GameView(QGraphicsScene* scene, QWidget* parent)
+    : QGraphicsView(scene, parent)
+{
+}
+
+void GameView::paintEvent(QPaintEvent* event)
+{
+#ifdef GAME_PROFILING
+    if (m_frameTimer.isValid()) PROFILE_SAMPLE("frame", m_frameTimer.nsecsElapsed());
+    m_frameTimer.start();
+#endif
+    PROFILE_SCOPE("render");
+    QGraphicsView::paintEvent(event);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QGraphicsView>
+#include <QElapsedTimer>
+
+// GameView 类：游戏场景的视图，开启分节计时时记录每次重绘的耗时（render）与相邻两次重绘的间隔（frame）
+class GameView : public QGraphicsView {
+public:
+    explicit GameView(QGraphicsScene* scene, QWidget* parent = nullptr);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    QElapsedTimer m_frameTimer;
+};
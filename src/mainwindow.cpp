@@ -6,6 +6,9 @@
 #include "box.h"
 #include "powerupmanager.h"
 #include "savegamemanager.h"
+#include "gameloop.h"
+#include "profiler.h"
+#include "tracer.h"
 
 #include <QTimer>
 #include <QMenuBar>
@@ -26,6 +29,7 @@
 #include <QPen>
 #include <QDebug>
 #include <QDialog>
+#include <QtConcurrent>
 
 // mainwindow类构造函数
 MainWindow::MainWindow(QWidget *parent)
@@ -34,14 +38,12 @@ MainWindow::MainWindow(QWidget *parent)
     scene(nullptr),
     view(nullptr),
     gameMap(nullptr),
-    currentPathItem(nullptr),
+    effects(nullptr),
     countdownText(nullptr),
-    countdownTimer(new QTimer(this)),
     isPaused(false),
     score(nullptr),
     saveManager(this),
-    powerUpManager(nullptr),
-    powerUpSpawnTimer(nullptr)
+    powerUpManager(nullptr)
 {
     setWindowTitle(tr("请问您今天要来点八目鳗吗？"));
     resize(1200, 675);
@@ -67,12 +69,18 @@ MainWindow::MainWindow(QWidget *parent)
     connect(&saveManager, &SaveGameManager::errorOccurred, this, [this](const QString &message) {
         QMessageBox::warning(this, tr("加载失败"), message);
     });
+
+    // 可消性检查的结果在 GUI 线程处理
+    connect(&clearCheckWatcher, &QFutureWatcher<BoardSolver::Result>::finished,
+            this, &MainWindow::onClearCheckFinished);
 }
 
 // mainwindow类析构函数
 MainWindow::~MainWindow()
 {
     qDebug() << "MainWindow destructor called";
+    // 工作线程里可能还在用 boardSolver，等它结束（最多一个求解时限）
+    clearCheckWatcher.waitForFinished();
     // 清理游戏资源（StartMenu 由 parent 自动删除）
     cleanupGameResources();
 }
@@ -122,13 +130,18 @@ void MainWindow::setupSceneDefaults(QGraphicsScene *s)
 // 开始游戏：创建 scene/view/map/角色。作为startMenu发出信号的slot函数（lambda表达式作为slot）
 void MainWindow::startGame(int playerCount)
 {
+    TRACE_SCOPE("MainWindow::startGame");
     qDebug() << "=== Starting game with" << playerCount << "players ===";
 
     // 如果已有游戏在运行，先清理
     cleanupGameResources();
+    unclearableWarned = false;
 
     // 确保所有删除操作完成
-    QCoreApplication::processEvents();
+    {
+        TRACE_SCOPE("processEvents");
+        QCoreApplication::processEvents();
+    }
 
     // 从startMenu获取配置参数（x,y箱子个数与种类）
     if (startMenu) {
@@ -143,9 +156,10 @@ void MainWindow::startGame(int playerCount)
     // 新建 scene 和 view
     scene = new QGraphicsScene(this);
     setupSceneDefaults(scene);
+    effects = new EffectPool(scene);
 
     // 抗锯齿与性能
-    view = new QGraphicsView(scene, this);
+    view = new GameView(scene, this);
     view->setRenderHint(QPainter::Antialiasing);
     view->setRenderHint(QPainter::TextAntialiasing);
     view->setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
@@ -161,9 +175,10 @@ void MainWindow::startGame(int playerCount)
 
     // 创建box地图并加入场景
     gameMap = new Map(yNum, xNum, typeNum, ":/assets/ingredient.png", scene, 26);
+    gameMap->setBoardLayerEnabled(yNum * xNum >= boardLayerMinCells);
 
     // 初始化道具管理器（依赖 map）
-    powerUpManager->initialize(gameMap, scene);
+    powerUpManager->initialize(gameMap, scene, &sessionTimers);
 
     // 创建角色 - 确保完全清理旧角色
     characters.clear();
@@ -188,13 +203,9 @@ void MainWindow::startGame(int playerCount)
         qDebug() << "Created player 2";
     }
 
-    // 道具生成定时器（每15s生成1个）
-    powerUpSpawnTimer = new QTimer(this);
-    connect(powerUpSpawnTimer, &QTimer::timeout, this, [this]() {
-        if (powerUpManager) powerUpManager->spawnPowerUp(QRandomGenerator::global()->bounded(3) + 1);
-    });
+    // 开局先生成1个道具，之后每15s生成1个（由游戏循环计时）
     if (powerUpManager) powerUpManager->spawnPowerUp(QRandomGenerator::global()->bounded(3) + 1);
-    powerUpSpawnTimer->start(15000);
+    powerUpSpawnCadence.reset();
 
     // 倒计时文本
     countdownTime = initialCountdownTime;
@@ -204,15 +215,23 @@ void MainWindow::startGame(int playerCount)
     countdownText->setZValue(102);
     countdownText->setPos(20, 20);
 
-    // 连接倒计时，如果已经存在先消除
-    if (countdownTimer) {
-        countdownTimer->stop();
-        disconnect(countdownTimer, nullptr, this, nullptr);
-    }
-    connect(countdownTimer, &QTimer::timeout, this, &MainWindow::updateCountdown);
-    countdownTimer->start(1000);
-
-    isPaused = false;
+    // 调试面板（保持上一局的开关状态）
+    debugHud = new DebugHud();
+    debugHud->setVisible(debugHudVisible);
+    scene->addItem(debugHud);
+    debugHudCadence.reset();
+
+    // 游戏循环：角色、倒计时、道具统一按固定步长推进，如果已经存在先消除
+    countdownCadence.reset();
+    if (gameLoop) {
+        gameLoop->stop();
+        gameLoop->deleteLater();
+    }
+    gameLoop = new GameLoop(gameStepMs, this);
+    gameLoop->setClock(&gameClock);
+    connect(gameLoop, &GameLoop::tick, this, &MainWindow::onGameTick);
+    setGamePaused(false);
+    gameLoop->start();
     qDebug() << "=== Game started successfully ===";
 }
 
@@ -223,27 +242,34 @@ void MainWindow::cleanupGameResources()
     if (isCleaningUp) return;
     isCleaningUp = true;
 
+    TRACE_SCOPE("MainWindow::cleanupGameResources");
     qDebug() << "=== Starting cleanupGameResources ===";
 
-    // 0. 消除 menuBar
+    // 0. 消除 menuBar（clear() 只移除动作，菜单与其中的动作要另外删除，否则每局累积一份；
+    // 可能正处于菜单动作的 triggered 里，所以延迟删除）
     if (menuBar()) {
+        const QList<QMenu*> menus = menuBar()->findChildren<QMenu*>(QString(), Qt::FindDirectChildrenOnly);
         menuBar()->clear();
+        for (QMenu* menu : menus) menu->deleteLater();
     }
 
-    // 1. 停止所有定时器
-    if (countdownTimer) {
-        countdownTimer->stop();
-        disconnect(countdownTimer, nullptr, this, nullptr); // 断开 this 的所有连接（从任何发送者）
-    }
-
-    if (powerUpSpawnTimer) {
-        powerUpSpawnTimer->stop();
-        disconnect(powerUpSpawnTimer, nullptr, this, nullptr);
-        powerUpSpawnTimer->deleteLater();
+    // 1. 停止游戏循环
+    if (gameLoop) {
+        const GameLoop::Jitter jitter = gameLoop->jitter();
+        qDebug() << "Game loop ticks:" << gameLoop->tickCount() << "jitter(ms) mean:" << jitter.meanMs
+                 << "max:" << jitter.maxMs;
+        gameLoop->stop();
+        disconnect(gameLoop, nullptr, this, nullptr); // 断开 this 的所有连接（从任何发送者）
+        gameLoop->deleteLater();
         // deleteLater() 是 QObject 的一个槽函数，它不会立即删除对象，而是将删除请求放入事件循环，在下次事件处理时安全地删除对象。
-        powerUpSpawnTimer = nullptr;
+        gameLoop = nullptr;
     }
 
+    // 取消未到期的短时事件，反馈文字、连线随场景一并删除
+    qDebug() << "Pending session timers:" << sessionTimers.pendingCount();
+    sessionTimers.clear();
+    clearCheckSender = nullptr;     // 进行中的可消性检查结果会因版本号不符被丢弃
+
     // 2. 停用道具类powerUpManager
     if (powerUpManager) {
         powerUpManager->deactivateHint();
@@ -263,9 +289,6 @@ void MainWindow::cleanupGameResources()
             // 断开所有连接
             disconnect(character, nullptr, this, nullptr);
 
-            // 停止定时器
-            character->stopTimers();
-
             // 从场景中移除
             if (scene && scene->items().contains(character)) {
                 scene->removeItem(character);
@@ -279,13 +302,10 @@ void MainWindow::cleanupGameResources()
     }
     characters.clear();
 
-    // 4. 清理路径项 (QGraphicsPathItem 不是 QObject，需要直接删除)
-    if (currentPathItem) {
-        if (scene && scene->items().contains(currentPathItem)) {
-            scene->removeItem(currentPathItem);
-        }
-        delete currentPathItem; // 直接删除
-        currentPathItem = nullptr;
+    // 4. 清理连线与反馈文字图元池（图元不是 QObject，由池直接删除；定时器已清空，不会再归还）
+    if (effects) {
+        delete effects;
+        effects = nullptr;
     }
 
     // 5. 清理倒计时文本 (QGraphicsTextItem 不是 QObject，需要直接删除)
@@ -297,11 +317,24 @@ void MainWindow::cleanupGameResources()
         countdownText = nullptr;
     }
 
+    // 调试面板同样直接删除（析构时撤掉事件过滤器）
+    if (debugHud) {
+        if (scene && scene->items().contains(debugHud)) {
+            scene->removeItem(debugHud);
+        }
+        delete debugHud;
+        debugHud = nullptr;
+    }
+
     // 6. 清理 view 和 scene (QGraphicsView 是 QObject，可以使用 deleteLater)
+    // scene 以 MainWindow 为父对象，不删除的话每局的箱子、道具、背景会一直留到窗口关闭
     if (view) {
         setCentralWidget(nullptr);
         view->deleteLater();
         view = nullptr;
+    }
+    if (scene) {
+        scene->deleteLater();
         scene = nullptr;
     }
 
@@ -317,7 +350,10 @@ void MainWindow::cleanupGameResources()
     isPaused = false;
 
     // 强制处理所有待删除对象
-    QCoreApplication::processEvents();
+    {
+        TRACE_SCOPE("processEvents");
+        QCoreApplication::processEvents();
+    }
 
     qDebug() << "=== Finished cleanupGameResources ===";
     isCleaningUp = false;
@@ -335,7 +371,10 @@ void MainWindow::resetToTitleScreen()
     cleanupGameResources();
 
     // 确保所有删除操作完成
-    QCoreApplication::processEvents();
+    {
+        TRACE_SCOPE("processEvents");
+        QCoreApplication::processEvents();
+    }
 
     // 创建新的开始菜单
     startMenu = new StartMenu(this);
@@ -369,6 +408,16 @@ void MainWindow::keyPressEvent(QKeyEvent *event)
         return;
     }
 
+    if (event->key() == Qt::Key_F3) {
+        toggleDebugHud();
+        return;
+    }
+
+    if (event->key() == Qt::Key_F4) {
+        dumpMemoryReport();
+        return;
+    }
+
     // 更严格的安全检查
     if (characters.isEmpty() || !scene || !gameMap) {
         qDebug() << "Key press ignored - game not ready";
@@ -407,15 +456,43 @@ void MainWindow::keyReleaseEvent(QKeyEvent *event)
     }
 }
 
-// 倒计时的暂停、终止逻辑
-void MainWindow::updateCountdown()
+// 游戏循环的每个固定步长：推进角色、道具与短时事件，累计满1s走一次倒计时、满15s生成一个道具
+// 暂停时整体冻结
+void MainWindow::onGameTick(int stepMs)
 {
+    if (debugHudCadence.advance(stepMs) > 0) refreshDebugHud();
     if (isPaused) return;
+    PROFILE_SCOPE("tick");
+    TRACE_SCOPE("MainWindow::onGameTick");
+
+    // 角色碰撞处理中可能已结束本局，每步之后都要重新确认
+    const QVector<Character*> stepping = characters;
+    for (Character* c : stepping) {
+        if (c) {
+            TRACE_SCOPE("Character::step");
+            c->step(stepMs);
+        }
+        if (!gameLoop || isPaused) return;
+    }
+
+    if (powerUpManager) powerUpManager->update(stepMs);
+    sessionTimers.advance(stepMs);
+    if (!gameLoop || isPaused) return;
+
+    for (int n = powerUpSpawnCadence.advance(stepMs); n > 0; --n)
+        if (powerUpManager) powerUpManager->spawnPowerUp(QRandomGenerator::global()->bounded(3) + 1);
 
+    for (int n = countdownCadence.advance(stepMs); n > 0 && gameLoop && !isPaused; --n)
+        updateCountdown();
+}
+
+// 倒计时的终止逻辑
+void MainWindow::updateCountdown()
+{
     countdownTime--;
     if (countdownTime < 0) {
         countdownTime = 0;
-        countdownTimer->stop();
+        if (gameLoop) gameLoop->stop();
         showGameOverDialog();
         return;
     }
@@ -432,8 +509,48 @@ void MainWindow::addCountdownTime(int seconds)
 // 暂停与继续切换
 void MainWindow::togglePause()
 {
-    isPaused = !isPaused;
-    for (Character* c : characters) c->isPaused = isPaused;
+    setGamePaused(!isPaused);
+}
+
+// 显示/隐藏调试面板
+void MainWindow::toggleDebugHud()
+{
+    debugHudVisible = !debugHudVisible;
+    if (!debugHud) return;
+    debugHud->setVisible(debugHudVisible);
+    if (debugHudVisible) refreshDebugHud();
+}
+
+void MainWindow::refreshDebugHud()
+{
+    if (!debugHud || !debugHud->isVisible()) return;
+    debugHud->refresh({
+        { "boxes", gameMap ? int(gameMap->m_boxes.size()) : 0 },
+        { "tools", gameMap ? int(gameMap->m_tools.size()) : 0 },
+        { "characters", int(characters.size()) },
+        { "timers", sessionTimers.pendingCount() }
+    }, memoryReport().lines());
+}
+
+MemoryReport MainWindow::memoryReport() const
+{
+    return MemoryReport::capture(gameMap, scene, effects);
+}
+
+// 把内存快照写到日志（F4）
+void MainWindow::dumpMemoryReport()
+{
+    qDebug() << "=== Memory report ===";
+    for (const QString &line : memoryReport().lines())
+        qDebug().noquote() << line;
+}
+
+// 暂停/继续：角色停止响应，游戏时钟冻结，倒计时、道具、提示等一切计时随之停住
+void MainWindow::setGamePaused(bool paused)
+{
+    isPaused = paused;
+    for (Character* c : characters) c->isPaused = paused;
+    gameClock.setPaused(paused);
 }
 
 // 角色与box交互，传入碰撞的box和character对象指针
@@ -462,9 +579,13 @@ void MainWindow::handleToolActivation(Box* box, Character* sender)
     }
 
     // 清理道具
-    if (gameMap) gameMap->m_tools.removeOne(box);
-    if (scene) scene->removeItem(box);
-    delete box;
+    if (powerUpManager) {
+        powerUpManager->removePowerUp(box);
+    } else {
+        if (gameMap) gameMap->removeTool(box);
+        if (scene) scene->removeItem(box);
+        delete box;
+    }
 }
 
 void MainWindow::handleAddTimeTool(Character* sender)
@@ -476,6 +597,7 @@ void MainWindow::handleAddTimeTool(Character* sender)
 void MainWindow::handleShuffleTool(Character* sender)
 {
     if (gameMap) gameMap->shuffleBoxes();
+    unclearableWarned = false;
     showFeedbackText("Shuffle!", Qt::blue, sender->getPosition());
 }
 
@@ -488,19 +610,12 @@ void MainWindow::handleHintTool(Character* sender)
 // 道具激活后反馈效果
 void MainWindow::showFeedbackText(const QString& text, const QColor& color, const QPointF& position)
 {
-    if (!scene) return;
-
-    QGraphicsTextItem* feedback = scene->addText(text);
-    feedback->setDefaultTextColor(color);
-    feedback->setFont(QFont("Consolas", 16, QFont::Bold));
-    feedback->setZValue(100);
-    feedback->setPos(position);
+    if (!scene || !effects) return;
 
-    QTimer::singleShot(1000, [feedback]() {
-        if (feedback->scene()) {
-            feedback->scene()->removeItem(feedback);
-            delete feedback;
-        }
+    // 从池中取一个文字图元，1秒（游戏时间）后隐藏归还
+    QGraphicsTextItem* feedback = effects->showText(text, color, position);
+    sessionTimers.schedule(1000, [this, feedback]() {
+        if (effects) effects->release(feedback);
     });
 }
 
@@ -519,44 +634,96 @@ void MainWindow::handleBoxConnection(Box* box, Character* sender)
     // 重复点击相同方块
     if (box == lastBox) return;
 
-    // 尝试连接方块
-    if (gameMap->canConnect(lastBox, box)) {
-        handleSuccessfulConnection(lastBox, box, sender);
+    // 尝试连接方块，路径随结果返回，不受其他查询（如提示）干扰
+    const MapPath path = gameMap->findPath(lastBox, box);
+    if (path.found) {
+        handleSuccessfulConnection(lastBox, box, sender, path);
     } else {
         handleFailedConnection(lastBox, box, sender);
     }
 
-    // 检查游戏是否可解
+    // 检查游戏是否可解：当前无可消对则结束，否则检查能否全部消除
     if (gameMap && !gameMap->isSolvable()) {
         showGameOverDialog();
+    } else if (path.found) {
+        checkBoardClearable(sender);
+    }
+}
+
+// 还有可消对但已无法全部消除时提前提醒（同一局面只提醒一次，洗牌、读档、新开局后重新判断）
+// 求解放到线程池，GUI 线程只拍快照；上一次求解还没结束时不重复发起，结束后发现棋盘已变化会自动重查
+void MainWindow::checkBoardClearable(Character* sender)
+{
+    if (!gameMap || unclearableWarned) return;
+
+    clearCheckSender = sender;
+    if (clearCheckPending) return;
+
+    clearCheckPending = true;
+    clearCheckRevision = gameMap->revision();
+    boardSolver.setTimeLimit(clearCheckBudgetMs);
+    const BoardGrid board = gameMap->snapshot();
+    clearCheckWatcher.setFuture(QtConcurrent::run([this, board]() { return boardSolver.solve(board); }));
+}
+
+// 可消性检查结束：在 GUI 线程记录耗时，棋盘未变化时才采信结果
+void MainWindow::onClearCheckFinished()
+{
+    clearCheckPending = false;
+    const BoardSolver::Result result = clearCheckWatcher.result();
+    PROFILE_SAMPLE("solver", result.elapsedUs * 1000);
+    qDebug() << "Clearable check:" << result.solvable << "finished:" << result.finished
+             << "nodes:" << result.nodes << "time(us):" << result.elapsedUs;
+
+    if (!gameMap || unclearableWarned) return;
+    if (gameMap->revision() != clearCheckRevision) {
+        // 求解期间又有消除、洗牌或换局，结果已过时，对当前棋盘重新检查
+        if (clearCheckSender) checkBoardClearable(clearCheckSender);
+        return;
+    }
+
+    if (result.finished && !result.solvable) {
+        unclearableWarned = true;
+        const QPointF position = clearCheckSender ? clearCheckSender->getPosition() : mapPixSize / 2;
+        showFeedbackText("Dead end!", Qt::red, position);
     }
 }
 
 // 可以消除
-void MainWindow::handleSuccessfulConnection(Box* box1, Box* box2, Character* sender)
+void MainWindow::handleSuccessfulConnection(Box* box1, Box* box2, Character* sender, const MapPath& path)
 {
     // 移除方块状态
     box1->deactivate();
     box2->deactivate();
 
     // 更新游戏数据
-    gameMap->m_map[box1->row][box1->col] = -1;
-    gameMap->m_map[box2->row][box2->col] = -1;
+    gameMap->setCell(box1->row, box1->col, -1);
+    gameMap->setCell(box2->row, box2->col, -1);
 
     // 移除场景对象
     scene->removeItem(box1);
     scene->removeItem(box2);
 
-    // 清理数据
+    // 清理数据：先让角色与提示丢掉对这两个箱子的引用，再删除（否则每消一对就泄漏一对，直到窗口关闭）
+    for (Character* c : characters) {
+        c->forgetBox(box1);
+        c->forgetBox(box2);
+    }
+    if (powerUpManager) {
+        powerUpManager->forgetBox(box1);
+        powerUpManager->forgetBox(box2);
+    }
     gameMap->m_boxes.removeOne(box1);
     gameMap->m_boxes.removeOne(box2);
+    delete box1;
+    delete box2;
     sender->setLastActivatedBox(nullptr);
 
     // 增加分数
     sender->getCharacterScore()->increase(10);
 
     // 显示连接路径
-    showConnectionPath();
+    showConnectionPath(path.pixels);
 }
 
 // 不能消除
@@ -568,34 +735,19 @@ void MainWindow::handleFailedConnection(Box* lastBox, Box* newBox, Character* se
 }
 
 // 绘制连线
-void MainWindow::showConnectionPath()
+void MainWindow::showConnectionPath(const QVector<QPointF>& pts)
 {
-    const QVector<QPointF>& pts = gameMap->m_pathPixels;
-    if (pts.size() < 2 || !scene) return;
+    if (pts.size() < 2 || !scene || !effects) return;
 
     // 创建路径
     QPainterPath path(pts[0]);
     for (int i = 1; i < pts.size(); ++i)
         path.lineTo(pts[i]);
 
-    // 设置画笔样式
-    QPen pen(QColor(155, 123, 128), 10);
-    pen.setJoinStyle(Qt::RoundJoin);
-    pen.setCapStyle(Qt::RoundCap);
-
-    // 添加到场景
-    QGraphicsPathItem* lineItem = scene->addPath(path, pen);
-    lineItem->setZValue(-1);
-    currentPathItem = lineItem;
-
-    // 设置定时移除
-    QTimer::singleShot(500, [this, lineItem]() {
-        if (lineItem && lineItem->scene()) {
-            lineItem->scene()->removeItem(lineItem);
-            delete lineItem;
-            if (currentPathItem == lineItem)
-                currentPathItem = nullptr;
-        }
+    // 从池中取一个连线图元（画笔已设好），0.5秒（游戏时间）后隐藏归还
+    QGraphicsPathItem* lineItem = effects->showPath(path);
+    sessionTimers.schedule(500, [this, lineItem]() {
+        if (effects) effects->release(lineItem);
     });
 }
 
@@ -606,27 +758,35 @@ void MainWindow::createMenu()
 
     QMenu *gameMenu = menuBar()->addMenu(tr("选项")); //tr()为翻译函数，后续可使用lupdate提取文本生成.ts并编写对照翻译
 
-    QAction *saveAction = new QAction(tr("保存游戏"), this);    //QAction为动作类，此处通过gameMenu->addAction()添加到菜单项
+    QAction *saveAction = new QAction(tr("保存游戏"), gameMenu);    //QAction为动作类，此处通过gameMenu->addAction()添加到菜单项
     connect(saveAction, &QAction::triggered, this, &MainWindow::onSaveGame);
     gameMenu->addAction(saveAction);
 
-    QAction *loadAction = new QAction(tr("加载游戏"), this);
+    QAction *loadAction = new QAction(tr("加载游戏"), gameMenu);
     connect(loadAction, &QAction::triggered, this, &MainWindow::onLoadGame);
     gameMenu->addAction(loadAction);
 
     gameMenu->addSeparator();
 
-    QAction *togglePause = new QAction(tr("暂停/继续"), this);
+    QAction *togglePause = new QAction(tr("暂停/继续"), gameMenu);
     connect(togglePause, &QAction::triggered, this, &MainWindow::togglePause);
     gameMenu->addAction(togglePause);
 
+    QAction *debugAction = new QAction(tr("调试信息 (F3)"), gameMenu);
+    connect(debugAction, &QAction::triggered, this, &MainWindow::toggleDebugHud);
+    gameMenu->addAction(debugAction);
+
+    QAction *memoryAction = new QAction(tr("导出内存统计 (F4)"), gameMenu);
+    connect(memoryAction, &QAction::triggered, this, &MainWindow::dumpMemoryReport);
+    gameMenu->addAction(memoryAction);
+
     gameMenu->addSeparator();
 
-    QAction *exitAction = new QAction(tr("返回主菜单"), this);
+    QAction *exitAction = new QAction(tr("返回主菜单"), gameMenu);
     connect(exitAction, &QAction::triggered, this, [this]() { resetToTitleScreen(); });
     gameMenu->addAction(exitAction);
 
-    QAction *quitAction = new QAction(tr("退出程序"), this);
+    QAction *quitAction = new QAction(tr("退出程序"), gameMenu);
     connect(quitAction, &QAction::triggered, this, &QMainWindow::close);
     gameMenu->addAction(quitAction);
 }
@@ -635,8 +795,7 @@ void MainWindow::createMenu()
 void MainWindow::onSaveGame()
 {
     // 存档操作时暂停
-    isPaused = true;
-    for (Character* c : characters) c->isPaused = true;
+    setGamePaused(true);
 
     if (characters.isEmpty()) {
         QMessageBox::warning(this, tr("保存游戏"), tr("没有可用的角色"));
@@ -653,15 +812,13 @@ void MainWindow::onSaveGame()
     }
 
     // 游戏继续
-    isPaused = false;
-    for (Character* c : characters) c->isPaused = false;
+    setGamePaused(false);
 }
 
 // 读档，通过connect到菜单项由&QAction::triggered信号触发
 void MainWindow::onLoadGame()
 {
-    isPaused = true;
-    for (Character* c : characters) c->isPaused = true;
+    setGamePaused(true);
 
     // getOpenFileName完整文件路径到filename
     QString filename = QFileDialog::getOpenFileName(this, tr("加载游戏"), QDir::currentPath(), tr("连连看存档 (*.lksav)"));
@@ -677,6 +834,7 @@ void MainWindow::onLoadGame()
         // 调用现有的加载方法，并检查返回值
         if (saveManager.loadGame(filename, *gameMap, characters, countdownTime)) {
             QMessageBox::information(this, tr("加载游戏"), tr("游戏已成功加载!"));
+            unclearableWarned = false;
             if (countdownText) countdownText->setPlainText(QString("Time：%1").arg(countdownTime));
             for (Character* character : characters) {
                 character->getCharacterScore()->updateText();
@@ -686,8 +844,7 @@ void MainWindow::onLoadGame()
         }
     }
 
-    isPaused = false;
-    for (Character* c : characters) c->isPaused = false;
+    setGamePaused(false);
 }
 
 // Game Over弹窗
@@ -698,15 +855,7 @@ void MainWindow::showGameOverDialog()
     // 1. 先停止所有活动
     isPaused = true;
 
-    if (countdownTimer) {
-        countdownTimer->stop();
-        disconnect(countdownTimer, nullptr, this, nullptr);
-    }
-
-    if (powerUpSpawnTimer) {
-        powerUpSpawnTimer->stop();
-        disconnect(powerUpSpawnTimer, nullptr, this, nullptr);
-    }
+    if (gameLoop) gameLoop->stop();
 
     // 2. 根据游戏模式准备不同的消息
     QString gameOverMessage;
@@ -4,12 +4,23 @@
 #include <QGraphicsScene>
 #include <QGraphicsView>
 #include <QVector>
+#include <QPointF>
 #include <QTimer>
+#include <QPointer>
+#include <QFutureWatcher>
 #include "savegamemanager.h"
+#include "boardsolver.h"
+#include "gameloop.h"
+#include "timerwheel.h"
+#include "effectpool.h"
+#include "gameview.h"
+#include "debughud.h"
+#include "memoryreport.h"
 
 class Character;
 class Box;
 class Map;
+struct MapPath;
 class Score;
 class PowerUpManager;
 class StartMenu;
@@ -25,26 +36,42 @@ public:
     ~MainWindow();
     void addCountdownTime(int seconds);
 
+    // 场景尺寸与批量绘制阈值，离屏渲染基准等工具按与游戏相同的方式搭建场景
+    static constexpr qreal mapWidth = 800;
+    static constexpr qreal mapHeight = 600;
+    static constexpr int boardLayerMinCells = 60;  // 格子数不少于此值时改用批量绘制图层
+
+    // 为空场景设置尺寸、底色并添加3层背景贴图
+    static void setupSceneDefaults(QGraphicsScene *s);
+
+    // 开一局 / 清理本局全部资源（菜单与测试共用；清理后删除的对象要等事件循环处理延迟删除）
+    void startGame(int playerCount);
+    void cleanupGameResources();
+
+    // 当前的内存快照：存活对象数、按精灵图统计的像素、棋盘数据
+    MemoryReport memoryReport() const;
+
 protected:
     void keyPressEvent(QKeyEvent *event) override;
     void keyReleaseEvent(QKeyEvent *event) override;
 
 private slots:
-    void updateCountdown();
+    void onGameTick(int stepMs);
     void handleActivation(Box* box, Character* sender);
 
     void onSaveGame();
     void onLoadGame();
     void togglePause();
+    void toggleDebugHud();
+    void dumpMemoryReport();
 
 private:
     // helper functions
-    void setupSceneDefaults(QGraphicsScene *s);
     void createMenu();
-    void startGame(int playerCount);
-    void cleanupGameResources();
     void resetToTitleScreen();
     void showGameOverDialog();
+    void updateCountdown();
+    void setGamePaused(bool paused);
 
     // 道具处理函数
     void handleToolActivation(Box* box, Character* sender);
@@ -54,38 +81,56 @@ private:
 
     // 方块连接处理函数
     void handleBoxConnection(Box* box, Character* sender);
-    void handleSuccessfulConnection(Box* box1, Box* box2, Character* sender);
+    void handleSuccessfulConnection(Box* box1, Box* box2, Character* sender, const MapPath& path);
     void handleFailedConnection(Box* lastBox, Box* newBox, Character* sender);
 
     // 通用辅助函数
     void showFeedbackText(const QString& text, const QColor& color, const QPointF& position);
-    void showConnectionPath();
+    void showConnectionPath(const QVector<QPointF>& pts);
+    void checkBoardClearable(Character* sender);
+    void onClearCheckFinished();
 
 private:
-    // 主菜单（作为 MainWindow 的子控件并一直保留）
-    StartMenu* startMenu;
+    // 主菜单：开局时 setCentralWidget 会把它延迟删除，用 QPointer 在删除后自动置空
+    QPointer<StartMenu> startMenu;
 
     // 懒创建的图形元素
     QGraphicsScene *scene = nullptr;
-    QGraphicsView *view = nullptr;
+    GameView *view = nullptr;
 
     QVector<Character*> characters;
 
     // 地图与网格
-    const qreal mapWidth = 800;
-    const qreal mapHeight = 600;
     const QPointF mapPixSize = QPointF(mapWidth, mapHeight);
     int yNum = 4, xNum = 6, typeNum = 4;
     Map* gameMap = nullptr;
 
-    // 交互相关
-    QGraphicsPathItem* currentPathItem = nullptr;
+    // 交互相关：连线与反馈文字图元循环复用（每局随 scene 新建）
+    EffectPool* effects = nullptr;
+
+    // 全盘可消性检查：每次消除后在线程池里对快照求解，超时则不下结论
+    // 同一时间至多一个求解在跑；结果回到 GUI 线程时棋盘已变化（版本号不符）则丢弃并重新检查
+    BoardSolver boardSolver;
+    QFutureWatcher<BoardSolver::Result> clearCheckWatcher;
+    bool clearCheckPending = false;         // 已发起、结果尚未在 GUI 线程处理
+    quint64 clearCheckRevision = 0;         // 发起求解时的棋盘版本号
+    QPointer<Character> clearCheckSender;   // 最近一次消除的玩家，提示文字显示在它身边
+    const int clearCheckBudgetMs = 20;
+    bool unclearableWarned = false;
+
+    // 游戏循环（每局新建，固定步长 33ms）与它使用的游戏时钟（暂停即冻结全部计时）
+    GameClock gameClock;
+    GameLoop* gameLoop = nullptr;
+    const int gameStepMs = 33;
+
+    // 本局的短时事件（道具消失、反馈文字、连线淡出）挂在同一个时间轮上，随游戏循环推进
+    TimerWheel sessionTimers{gameStepMs};
 
     // 倒计时
     int initialCountdownTime = 120;
     int countdownTime = 0;
     QGraphicsTextItem* countdownText = nullptr;
-    QTimer* countdownTimer = nullptr;
+    Cadence countdownCadence{1000};
     bool isPaused = false;
 
     // 分数
@@ -96,5 +141,11 @@ private:
 
     // 道具管理
     PowerUpManager* powerUpManager = nullptr;
-    QTimer* powerUpSpawnTimer = nullptr;
+    Cadence powerUpSpawnCadence{15000};
+
+    // 调试面板（F3 开关，开关状态跨局保留），每0.5秒刷新一次
+    DebugHud* debugHud = nullptr;
+    bool debugHudVisible = false;
+    Cadence debugHudCadence{500};
+    void refreshDebugHud();
 };
@@ -1,9 +1,19 @@
 #include "map.h"
+#include "boardgenerator.h"
+#include "spriteatlas.h"
+#include "boardlayer.h"
 #include <QPixmap>
 #include <QRandomGenerator>
+#include <QBitArray>
 #include <QDebug>
+#include <QtMath>
 #include <random>
 #include <algorithm>
+#include <atomic>
+#include <utility>
+
+// 全局递增的棋盘版本号来源，所有 Map 共用，保证版本号跨局不重复
+static std::atomic<quint64> s_nextRevision{0};
 
 // 构造，传入行、列、方块种类、spritesheet贴图、所在场景、单帧方形贴图边长（pix)
 Map::Map(int rows, int cols, int typeCount,
@@ -18,7 +28,8 @@ Map::Map(int rows, int cols, int typeCount,
     m_typeCount(typeCount),
     m_frameSize(frameSize),
     m_spriteSheetPath(spriteSheetPath),
-    disOrder(nullptr)
+    m_seed(QRandomGenerator::global()->generate()),
+    m_shuffleRng(m_seed)
 {
     initMap();
     addToScene();
@@ -35,27 +46,55 @@ Map::~Map()
     // 因此在mainWindow中先清理scene再把m_boxes和m_tools数组清空（此时内部对象已经析构）
     m_boxes.clear();
     m_tools.clear();
-
-    delete[] disOrder;
-    disOrder = nullptr;
 }
 
 // ================= 工具函数 =================
 
-//  把格子坐标 (r,c) 转为像素中心点
+//  把格子坐标 (r,c) 转为像素中心点：按放置箱子时缓存的原点计算，不读 scene（可在工作线程调用）
 QPointF Map::cellCenterPx(int r, int c) const {
+    return QPointF(m_origin.x() + c * spacing, m_origin.y() + r * spacing);
+}
+// 场景坐标落在哪个格子附近（四舍五入到最近的格点）
+QPoint Map::cellAt(const QPointF& pos) const {
+    const QPointF origin = cellCenterPx(0, 0);
+    return QPoint(qFloor((pos.x() - origin.x()) / spacing + 0.5),
+                  qFloor((pos.y() - origin.y()) / spacing + 0.5));
+}
 
-    int totalWidth  = (m_cols - 1) * spacing;
-    int totalHeight = (m_rows - 1) * spacing;
+Box* Map::boxAt(int r, int c) const {
+    if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) return nullptr;
+    return m_cellBoxes[gridIndex(r + 1, c + 1)];
+}
 
-    QRectF sceneRect = m_scene->sceneRect();
-    QPointF sceneCenter = sceneRect.center();
+Box* Map::toolAt(int r, int c) const {
+    if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) return nullptr;
+    return m_cellTools[gridIndex(r + 1, c + 1)];
+}
 
-    qreal offsetX = sceneCenter.x() - totalWidth  / 2.0;
-    qreal offsetY = sceneCenter.y() - totalHeight / 2.0;
+// 1.5 倍格距大于碰撞与预选范围，周围 3x3 格足以覆盖所有可能碰到或预选的箱子
+void Map::itemsNear(const QPointF& pos, const QVector<Box*>& cells, QVector<Box*>& out) const {
+    out.clear();
+    const QPoint center = cellAt(pos);
+    const int r0 = qMax(0, center.y() - 1), r1 = qMin(m_rows - 1, center.y() + 1);
+    const int c0 = qMax(0, center.x() - 1), c1 = qMin(m_cols - 1, center.x() + 1);
+    for (int r = r0; r <= r1; ++r)
+        for (int c = c0; c <= c1; ++c)
+            if (Box* item = cells[gridIndex(r + 1, c + 1)])
+                out.append(item);
+}
+
+void Map::addTool(Box* tool) {
+    m_tools.append(tool);
+    if (tool->row >= 0 && tool->row < m_rows && tool->col >= 0 && tool->col < m_cols)
+        m_cellTools[gridIndex(tool->row + 1, tool->col + 1)] = tool;
+}
 
-    return QPointF(offsetX + c * spacing, offsetY + r * spacing);
+void Map::removeTool(Box* tool) {
+    m_tools.removeOne(tool);
+    if (toolAt(tool->row, tool->col) == tool)
+        m_cellTools[gridIndex(tool->row + 1, tool->col + 1)] = nullptr;
 }
+
 // 工具函数：网格转化为像素坐标
 QVector<QPointF> Map::cellsToScene(const QVector<QPoint>& cells) const {
     QVector<QPointF> result;
@@ -65,24 +104,18 @@ QVector<QPointF> Map::cellsToScene(const QVector<QPoint>& cells) const {
     return result;
 }
 
-// 辅助构造函数1：初始化地图，对spritesheet随机选择typecount帧编号，并与空格编号一起随机生成在地图二维数组m_map中
+// 辅助构造函数1：初始化地图，对spritesheet不重复地选择typecount帧编号，按逆序消除成对放入地图二维数组m_map
+// 空格比例沿用原先的 1/(typecount+1)
 void Map::initMap()
 {
-    disOrder = new int[m_typeCount + 1];    //乱序数组，存储随机到的box编号以及空格多（赋-1）
-    for (int i = 0; i < m_typeCount; ++i) {
-        //disOrder[i] = QRandomGenerator::global()->bounded(164);    // 精灵图recipe：164帧
-        disOrder[i] = QRandomGenerator::global()->bounded(62);    // 精灵图参数ingridient：62帧
-    }
-    disOrder[m_typeCount] = -1;
-
-    m_map.resize(m_rows);   // 二维数组m_map设置行数
-    for (int i = 0; i < m_rows; i++) {
-        m_map[i].resize(m_cols);
-        for (int j = 0; j < m_cols; j++) {
-            int randomIndex = QRandomGenerator::global()->bounded(m_typeCount + 1);
-            m_map[i][j] = disOrder[randomIndex];
-        }
-    }
+    BoardGenerator generator(m_seed);
+    generator.setFrameCount(SpriteAtlas::instance().frameCount(m_spriteSheetPath));    // 帧数来自图集元数据
+    generator.setEmptyRatio(1.0 / (m_typeCount + 1));
+    generator.setMaxTurns(m_board.maxTurns());
+    m_map = generator.generate(m_rows, m_cols, m_typeCount);
+    qDebug() << "Map generated with seed" << m_seed;
+
+    rebuildGrid();
 }
 
 // 辅助构造函数2： 按照m_map在scene中添加实体贴图
@@ -97,6 +130,7 @@ void Map::addToScene()
     QPointF sceneCenter = sceneRect.center();
     qreal offsetX = sceneCenter.x() - totalWidth  / 2.0;
     qreal offsetY = sceneCenter.y() - totalHeight / 2.0;
+    m_origin = QPointF(offsetX, offsetY);
 
     // 在“网格”结点上放置裁切后的spritesheet帧
     for (int i = 0; i < m_rows; i++) {
@@ -110,37 +144,31 @@ void Map::addToScene()
                         offsetY + i * spacing);
 
             Box *box = new Box(pos, m_spriteSheetPath, m_scene);
-            box->setPixmap(sprite);
+            box->setSprite(sprite);
             box->setZValue(1);
             box->row = i;
             box->col = j;
+            if (m_layer) {
+                box->layer = m_layer;
+                box->setVisible(false);
+            }
             m_boxes.append(box);
+            m_cellBoxes[gridIndex(i + 1, j + 1)] = box;
         }
     }
 }
 
-// spritesheet裁切，传入帧序号，返回相应帧（只要传入的m_frameSize与传入的spritesheet相匹配，可动态适应行列帧数）
+// 按类型编号取贴图：帧由图集预先切好并共享，不再每次从资源文件解码
 QPixmap Map::getSpriteByType(int typeId)
 {
-    QPixmap spriteSheet(m_spriteSheetPath);
-    if (spriteSheet.isNull()) {
-        qWarning() << "Failed to load sprite sheet:" << m_spriteSheetPath;
-        return QPixmap();
-    }
-
-    const int cols = spriteSheet.width() / m_frameSize;
-    int row = typeId / cols;
-    int col = typeId % cols;
-
-    // 裁切
-    QRect sourceRect(col * m_frameSize, row * m_frameSize,
-                     m_frameSize, m_frameSize);
-    return spriteSheet.copy(sourceRect);
+    return SpriteAtlas::instance().frame(m_spriteSheetPath, typeId);
 }
 
 // 读档设置地图数据，传入箱子类型序号的二维数组
 void Map::setMapData(const QVector<QVector<int>>& newMapData)
 {
+    TRACE_SCOPE("Map::setMapData");
+
     // 首先清理现有的箱子对象，避免内存泄漏
     qDeleteAll(m_boxes);
     m_boxes.clear();
@@ -149,6 +177,7 @@ void Map::setMapData(const QVector<QVector<int>>& newMapData)
 
     // 复制新的地图数据
     m_map = newMapData;
+    rebuildGrid();
     if (m_map.isEmpty() || m_map[0].isEmpty()) {
         qWarning() << "地图数据未初始化，无法创建箱子";    // 确保地图数据已初始化
         return;
@@ -161,251 +190,342 @@ void Map::setMapData(const QVector<QVector<int>>& newMapData)
 }
 
 
-// 路径判定
-// 直线连接，传入两点和padding后的地图矩阵，以及此时为空的路径数组（存储路径结点）
-bool Map::straightConnect(int r1, int c1, int r2, int c2,
-                          const QVector<QVector<int>>& grid,
-                          QVector<QPoint>& outPath) const
+// 修改单个格子，传入原map坐标和新类型（-1为空），m_map、padding 网格与可消对索引同步更新
+// 只有穿过该格的路径会受影响，而这类配对的两端必然都在该格两拐以内的射线可达范围内，故只重查这一小批
+void Map::setCell(int r, int c, int type)
 {
-    if (r1 == r2) {
-        for (int c = std::min(c1, c2) + 1; c < std::max(c1, c2); ++c)
-            if (grid[r1][c] != -1) return false;
-        outPath << QPoint(c1, r1) << QPoint(c2, r2);    //等价于outPath.append()
-        return true;
+    if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) return;
+
+    const int pr = r + 1, pc = c + 1;
+    const int idx = gridIndex(pr, pc);
+    const int oldType = m_board.typeAt(idx);
+    if (oldType == type) return;
+
+    // 旧箱子参与的配对全部作废
+    if (oldType != -1) dropMovesOf(idx);
+
+    if (type == -1) {
+        // 变空：只可能新增配对，在可达范围内两两重查同类型且尚未入表的配对
+        writeCell(r, c, type);
+        m_cellBoxes[idx] = nullptr;
+        m_board.collectReach(idx, m_reach);
+        const int n = m_reach.cells.size();
+        for (int i = 0; i < n; ++i) {
+            const int a = m_reach.cells[i];
+            for (int j = i + 1; j < n; ++j) {
+                const int b = m_reach.cells[j];
+                if (m_board.typeAt(a) != m_board.typeAt(b) || m_moveSlot.contains(moveKey(a, b))) continue;
+                if (m_board.linkable(a, b))
+                    addMove(a, b);
+            }
+        }
+        return;
     }
-    if (c1 == c2) {
-        for (int r = std::min(r1, r2) + 1; r < std::max(r1, r2); ++r)
-            if (grid[r][c1] != -1) return false;
-        outPath << QPoint(c1, r1) << QPoint(c2, r2);
-        return true;
+
+    // 变满（或换类型）：可达范围在写入前计算，格子为空时的射线范围恰好覆盖所有穿过它的路径
+    m_board.collectReach(idx, m_reach);
+    writeCell(r, c, type);
+
+    if (oldType == -1) {
+        // 原本经过此格的配对可能被堵住，逐一复查
+        for (int a : std::as_const(m_reach.cells)) {
+            const QVector<int> partners = m_partners[a];
+            for (int b : partners) {
+                if (b < a || m_reach.mark[b] != m_reach.stamp) continue;
+                if (!m_board.linkable(a, b))
+                    removeMove(a, b);
+            }
+        }
     }
-    return false;
+
+    // 新箱子与射线可达的同类型箱子直接成对
+    for (int b : std::as_const(m_reach.cells))
+        if (m_board.typeAt(b) == type) addMove(idx, b);
 }
 
-bool Map::oneTurnConnect(int r1, int c1, int r2, int c2,
-                         const QVector<QVector<int>>& grid,
-                         QVector<QPoint>& outPath) const
+// 只写格子数据，不维护可消对索引（洗牌等批量修改用，结束后统一 rebuildMoveIndex()）
+void Map::writeCell(int r, int c, int type)
 {
-    // 拐点1 (r1, c2)
-    if (grid[r1][c2] == -1) {
-        QVector<QPoint> tmp;    //tmp没用，仅仅作为straightConnect()所需传入；函数执行完毕离开作用域时，会自动调用析构函数释放QVector对象内存
-        if (straightConnect(r1, c1, r1, c2, grid, tmp) &&
-            straightConnect(r1, c2, r2, c2, grid, tmp)) {
-            outPath << QPoint(c1, r1) << QPoint(c2, r1) << QPoint(c2, r2);
-            return true;
-        }
-    }
-    // 拐点2 (r2, c1)
-    if (grid[r2][c1] == -1) {
-        QVector<QPoint> tmp;
-        if (straightConnect(r1, c1, r2, c1, grid, tmp) &&
-            straightConnect(r2, c1, r2, c2, grid, tmp)) {
-            outPath << QPoint(c1, r1) << QPoint(c1, r2) << QPoint(c2, r2);
-            return true;
-        }
-    }
-    return false;
+    m_map[r][c] = type;
+    m_board.set(r + 1, c + 1, type);
+    m_revision = ++s_nextRevision;
+    if (m_layer) m_layer->setTile(r, c, type);
 }
 
-bool Map::twoTurnConnect(int r1, int c1, int r2, int c2,
-                         const QVector<QVector<int>>& grid,
-                         int rows, int cols,
-                         QVector<QPoint>& outPath) const
+// 由 m_map 重建 padding 网格与行列位图
+void Map::rebuildGrid()
 {
-    // 从起点沿四个方向延伸
-    for (int c = c1 - 1; c >= 0; --c) { // 向左
-        if (grid[r1][c] != -1) break;
-        QVector<QPoint> tmp;
-        // 第一个拐点已经记录并作为起点传入oneTurnConnect()，故而tmp记录第一、二个拐点和终点
-        if (oneTurnConnect(r1, c, r2, c2, grid, tmp)) {
-            outPath << QPoint(c1, r1) << tmp;   //先传入起点，随后传入tmp
-            return true;
-        }
-    }
-    for (int c = c1 + 1; c < cols; ++c) {
-        if (grid[r1][c] != -1) break;
-        QVector<QPoint> tmp;
-        if (oneTurnConnect(r1, c, r2, c2, grid, tmp)) {
-            outPath << QPoint(c1, r1) << tmp;
-            return true;
-        }
-    }
-    for (int r = r1 - 1; r >= 0; --r) { //向上
-        if (grid[r][c1] != -1) break;
-        QVector<QPoint> tmp;
-        if (oneTurnConnect(r, c1, r2, c2, grid, tmp)) {
-            outPath << QPoint(c1, r1) << tmp;
-            return true;
-        }
+    m_board.assign(m_rows, m_cols, m_map);
+    m_revision = ++s_nextRevision;
+    m_cellBoxes.fill(nullptr, m_board.cellCount());
+    m_cellTools.fill(nullptr, m_board.cellCount());
+    for (Box* tool : std::as_const(m_tools))
+        if (tool->row >= 0 && tool->row < m_rows && tool->col >= 0 && tool->col < m_cols)
+            m_cellTools[gridIndex(tool->row + 1, tool->col + 1)] = tool;
+    rebuildMoveIndex();
+    syncBoardLayer();
+}
+
+// 开关批量绘制模式：开启时新建图层并隐藏全部 Box，关闭时删除图层并恢复 Box 显示
+void Map::setBoardLayerEnabled(bool enabled)
+{
+    if (enabled == (m_layer != nullptr)) return;
+
+    if (enabled) {
+        m_layer = new BoardLayer(m_rows, m_cols, m_spriteSheetPath, m_frameSize);
+        m_layer->setGeometry(cellCenterPx(0, 0), spacing);
+        m_scene->addItem(m_layer);
+        syncBoardLayer();
+    } else {
+        m_scene->removeItem(m_layer);
+        delete m_layer;
+        m_layer = nullptr;
     }
-    for (int r = r1 + 1; r < rows; ++r) {
-        if (grid[r][c1] != -1) break;
-        QVector<QPoint> tmp;
-        if (oneTurnConnect(r, c1, r2, c2, grid, tmp)) {
-            outPath << QPoint(c1, r1) << tmp;
-            return true;
-        }
+
+    for (Box* box : std::as_const(m_boxes)) {
+        box->layer = m_layer;
+        box->setVisible(!enabled);
+        box->syncLayer();
     }
-    return false;
 }
 
-// 判断是否可连接，传入需判断的两个箱子指针
-bool Map::canConnect(Box* a, Box* b)
+// 图层按 m_map 整体刷新（初始化、读档时调用）
+void Map::syncBoardLayer()
 {
-    if (!a || !b) return false;
-    if (a == b) return false;
-    if (m_map[a->row][a->col] != m_map[b->row][b->col]) return false;
-
-    int rows = m_rows;
-    int cols = m_cols;
+    if (!m_layer) return;
+    for (int i = 0; i < m_rows && i < m_map.size(); i++)
+        for (int j = 0; j < m_cols && j < m_map[i].size(); j++)
+            m_layer->setTile(i, j, m_map[i][j]);
+}
 
-    //padding矩阵初始化为全-1
-    QVector<QVector<int>> grid(rows + 2, QVector<int>(cols + 2, -1));
+// 查询两个箱子之间的连线，传入需判断的两个箱子指针
+MapPath Map::findPath(Box* a, Box* b) const
+{
+    if (!a || !b || a == b) return MapPath();
+    return findPath(a->row, a->col, b->row, b->col);
+}
 
-    padding(grid);
+MapPath Map::findPath(int r1, int c1, int r2, int c2) const
+{
+    MapPath result;
+    if (r1 < 0 || r1 >= m_rows || c1 < 0 || c1 >= m_cols) return result;
+    if (r2 < 0 || r2 >= m_rows || c2 < 0 || c2 >= m_cols) return result;
+    if (r1 == r2 && c1 == c2) return result;
+
+    //在padding网格中坐标a(c1,r1),b(c2,r2) （对应(x,y)但不是实际坐标，是格子序号）
+    const int source = gridIndex(r1 + 1, c1 + 1);
+    const int target = gridIndex(r2 + 1, c2 + 1);
+    const int type = m_board.typeAt(source);
+    if (type == -1 || type != m_board.typeAt(target)) return result;
+
+    // 分层 BFS：先保证拐弯最少，再取其中最短的一条
+    if (!m_board.findPath(source, target, &result.cells, &result.turns)) return result;
+    result.pixels = cellsToScene(result.cells);
+    result.found = true;
+    return result;
+}
 
-    //在grid中坐标a(c1,r1),b(c2,r2) （对应(x,y)但不是实际坐标，是格子序号）
-    int r1 = a->row + 1, c1 = a->col + 1;
-    int r2 = b->row + 1, c2 = b->col + 1;
+// 设置连线规则的最大拐弯数，规则变化后可消对需要整体重算
+void Map::setMaxTurns(int turns)
+{
+    const int old = m_board.maxTurns();
+    m_board.setMaxTurns(turns);
+    if (m_board.maxTurns() != old) rebuildMoveIndex();
+}
 
-    grid[r1][c1] = -1;
-    grid[r2][c2] = -1;
+// 批量列出全部可消对，扫描本身由 BoardGrid 完成
+void Map::enumerateMoves(QVector<MapMove>& out) const
+{
+    m_board.enumerateMoves(out);
+}
 
-    QVector<QPoint> path;
+// 可消对索引：新增一对
+void Map::addMove(int a, int b)
+{
+    const qint64 key = moveKey(a, b);
+    if (m_moveSlot.contains(key)) return;
+    m_moveSlot.insert(key, m_moves.size());
+    m_moves.append(qMakePair(std::min(a, b), std::max(a, b)));
+    m_partners[a].append(b);
+    m_partners[b].append(a);
+}
 
-    if (straightConnect(r1, c1, r2, c2, grid, path) ||  //此时传入path为空
-        oneTurnConnect(r1, c1, r2, c2, grid, path) ||
-        twoTurnConnect(r1, c1, r2, c2, grid, rows+2, cols+2, path)) {
-        m_pathCells = path;
-        m_pathPixels = cellsToScene(path);
-        return true;
+// 可消对索引：删除一对（与末尾元素交换后删除，O(1)）
+void Map::removeMove(int a, int b)
+{
+    const qint64 key = moveKey(a, b);
+    if (!m_moveSlot.contains(key)) return;
+
+    const int slot = m_moveSlot.take(key);
+    const QPair<int, int> last = m_moves.takeLast();
+    if (slot < m_moves.size()) {
+        m_moves[slot] = last;
+        m_moveSlot[moveKey(last.first, last.second)] = slot;
     }
+    m_partners[a].removeOne(b);
+    m_partners[b].removeOne(a);
+}
 
-    return false;
+// 删除某格参与的全部配对
+void Map::dropMovesOf(int idx)
+{
+    while (!m_partners[idx].isEmpty())
+        removeMove(idx, m_partners[idx].last());
 }
 
-// 工具函数：padding，传入需要padding的矩阵
-void Map::padding(QVector<QVector<int>> &grid)
+// 全量重建可消对索引（初始化、读档、洗牌后调用）
+// 在棋盘快照上按类型分组求出全部配对（大棋盘各组并行），再在本线程写入索引
+void Map::rebuildMoveIndex()
 {
-    for (int i = 0; i < m_rows; i++)
-        for (int j = 0; j < m_cols; j++)
-            grid[i+1][j+1] = m_map[i][j];
+    m_moves.clear();
+    m_moveSlot.clear();
+    m_partners.clear();
+    m_partners.resize(m_board.cellCount());
+
+    const BoardGrid board = snapshot();
+    const QVector<QPair<int, int>> moves = board.allMoves();
+    m_moves.reserve(moves.size());
+    for (const QPair<int, int> &move : moves)
+        addMove(move.first, move.second);
 }
 
-// 直接遍历 m_boxes，按 type 聚合 Box*存储在键值对typeGroups中，然后两两调用 canConnect
-bool Map::isSolvable()
+// 任取一对当前可消的箱子（提示用），没有则返回空对
+QPair<Box*, Box*> Map::anyConnectablePair() const
 {
-    //键值对，eg.:{1: [(0,0), (1,1)], 2: [(2,2)]}
-    QMap<int, QVector<Box*>> typeGroups;
-
-    for (Box* box : m_boxes) {
-        if (!box) continue;
-        int r = box->row;
-        int c = box->col;
-        // 防护：坐标越界或已经被标记为 -1（空位）就跳过
-        if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) continue;
-        int type = m_map[r][c];
-        if (type != -1) {
-            typeGroups[type].append(box);
-        }
+    for (const QPair<int, int> &move : m_moves) {
+        Box* a = m_cellBoxes[move.first];
+        Box* b = m_cellBoxes[move.second];
+        if (a && b) return qMakePair(a, b);
     }
+    return qMakePair(nullptr, nullptr);
+}
 
-    for (auto it = typeGroups.begin(); it != typeGroups.end(); ++it) {
-        const QVector<Box*>& group = it.value();
-        int n = group.size();
-        for (int i = 0; i < n; ++i) {
-            for (int j = i + 1; j < n; ++j) {
-                Box* a = group[i];
-                Box* b = group[j];
-                if (!a || !b) continue;
-                if (canConnect(a, b)) {
-                    return true; // 找到一对可消，立即返回
-                }
-            }
-        }
-    }
+// 查表判断两箱子当前是否可消
+bool Map::isConnectablePair(Box* a, Box* b) const
+{
+    if (!a || !b || a == b) return false;
+    if (a->row < 0 || a->row >= m_rows || a->col < 0 || a->col >= m_cols) return false;
+    if (b->row < 0 || b->row >= m_rows || b->col < 0 || b->col >= m_cols) return false;
+    return m_moveSlot.contains(moveKey(gridIndex(a->row + 1, a->col + 1),
+                                       gridIndex(b->row + 1, b->col + 1)));
+}
 
-    return false;
+// 按容量估算棋盘数据的堆内存；QHash 的节点按 键+值+一个指针 近似
+qint64 Map::memoryBytes() const
+{
+    qint64 bytes = qint64(m_map.capacity()) * sizeof(QVector<int>);
+    for (const QVector<int> &row : m_map) bytes += qint64(row.capacity()) * sizeof(int);
+    for (const QVector<int> &partners : m_partners) bytes += qint64(partners.capacity()) * sizeof(int);
+
+    bytes += m_board.memoryBytes();
+    bytes += qint64(m_moves.capacity()) * sizeof(QPair<int, int>);
+    bytes += qint64(m_moveSlot.capacity()) * (sizeof(qint64) + sizeof(int) + sizeof(void*));
+    bytes += qint64(m_partners.capacity()) * sizeof(QVector<int>);
+    bytes += qint64(m_cellBoxes.capacity() + m_cellTools.capacity()
+                    + m_boxes.capacity() + m_tools.capacity()) * sizeof(Box*);
+    bytes += qint64(m_reach.cells.capacity() + m_reach.mark.capacity()) * sizeof(int);
+    return bytes;
 }
 
 // 道具具体实现：shuffle
+// 重排所有方块：方块带着各自的类型整体换位，贴图不变，只改格子和坐标
 void Map::shuffleBoxes()
 {
+    TRACE_SCOPE("Map::shuffleBoxes");
     if (m_boxes.isEmpty()) return;
 
-    // 1. 收集所有普通方块的类型（排除道具方块）
-    QVector<int> boxTypes;
-    for (Box* box : m_boxes) {
-        boxTypes.append(m_map[box->row][box->col]);
-    }
+    // 1. 收集所有普通方块的类型（第 i 个方块对应 boxTypes[i]）
+    const int count = m_boxes.size();
+    QVector<int> boxTypes(count);
+    for (int i = 0; i < count; i++)
+        boxTypes[i] = m_map[m_boxes[i]->row][m_boxes[i]->col];
+
+    // 2. 道具占据的格子记入位图，随后一遍扫描得到所有可用位置（排除道具），O(cells + tools)
+    QBitArray toolCells(m_rows * m_cols);
+    for (Box* tool : std::as_const(m_tools))
+        toolCells.setBit(tool->row * m_cols + tool->col);
 
-    // 2. 获取所有可用位置（排除道具方块占据的位置）
     QVector<QPoint> availablePositions;
+    availablePositions.reserve(m_rows * m_cols);
     for (int i = 0; i < m_rows; i++) {
         for (int j = 0; j < m_cols; j++) {
-            // 检查该位置是否被道具占据
-            bool occupiedByTool = false;
-            for (Box* tool : m_tools) {
-                if (tool->row == i && tool->col == j) {
-                    occupiedByTool = true;
-                    break;
-                }
-            }
-            if (!occupiedByTool) {
+            if (!toolCells.testBit(i * m_cols + j))
                 availablePositions.append(QPoint(j, i)); // QPoint(x,y) 对应 (col,row)
-            }
         }
     }
+    if (availablePositions.size() < count) return;
 
-    // 3. 随机打乱类型和位置
-    std::random_device rd;  // 真随机数生成器
-    std::mt19937 g(rd());   // 梅森旋转伪随机数生成器，并用真随机数初始化
-    std::shuffle(boxTypes.begin(), boxTypes.end(), g);  // 打乱方块类型数组，让不同类型的方块随机分布
-    std::shuffle(availablePositions.begin(), availablePositions.end(), g);  // 打乱可用位置数组，让方块的摆放位置随机化
+    // 3. 一次 Fisher–Yates 打乱可用位置，第 i 个方块放到第 i 个位置，其余位置为空
+    std::shuffle(availablePositions.begin(), availablePositions.end(), m_shuffleRng);
 
-    // 4. 更新地图数据和方块位置
-    // 先清空地图（保留道具位置）
-    for (int i = 0; i < m_rows; i++) {
-        for (int j = 0; j < m_cols; j++) {
-            // 如果不是道具位置，就设为-1
-            bool isToolPos = false;
-            for (Box* tool : m_tools) {
-                if (tool->row == i && tool->col == j) {
-                    isToolPos = true;
-                    break;
-                }
+    for (int i = 0; i < availablePositions.size(); i++) {
+        const QPoint &pos = availablePositions[i];
+        writeCell(pos.y(), pos.x(), i < count ? boxTypes[i] : -1);
+    }
+
+    // 4. 打乱后无可消对（死局）时原地修复，不再整盘重来：
+    //    把某个方块挪到同类型方块的相邻格（相邻必然直连），与该格原有的方块或空格互换
+    if (!m_board.findAnyMove()) {
+        QVector<int> slotAt(m_rows * m_cols, -1);   // 格子 -> availablePositions 中的位置
+        for (int i = 0; i < availablePositions.size(); i++)
+            slotAt[availablePositions[i].y() * m_cols + availablePositions[i].x()] = i;
+
+        QHash<int, int> firstOfType;    // 类型 -> 第一个该类型方块
+        bool repaired = false;
+        for (int y = 0; y < count && !repaired; y++) {
+            const int x = firstOfType.value(boxTypes[y], -1);
+            if (x < 0) {
+                firstOfType.insert(boxTypes[y], y);
+                continue;
             }
-            if (!isToolPos) {
-                m_map[i][j] = -1;
+
+            const QPoint anchor = availablePositions[x];
+            const QPoint steps[4] = { QPoint(1, 0), QPoint(-1, 0), QPoint(0, 1), QPoint(0, -1) };
+            for (const QPoint &step : steps) {
+                const QPoint target = anchor + step;
+                if (target.x() < 0 || target.x() >= m_cols || target.y() < 0 || target.y() >= m_rows) continue;
+                const int s = slotAt[target.y() * m_cols + target.x()];
+                if (s < 0) continue;    // 道具格
+
+                const QPoint from = availablePositions[y];
+                std::swap(availablePositions[y], availablePositions[s]);
+                writeCell(target.y(), target.x(), boxTypes[y]);
+                writeCell(from.y(), from.x(), s < count ? boxTypes[s] : -1);
+                repaired = true;
+                break;
             }
         }
+        qDebug() << "Shuffle left no move, repaired in place:" << repaired;
     }
 
-    // 5. 重新分配方块位置和更新场景显示
-    for (int i = 0; i < m_boxes.size() && i < availablePositions.size(); i++) {
+    // 5. 重新分配方块位置并更新场景显示
+    //    批量移动期间关闭场景索引，结束后恢复，索引只重建一次而不是每个方块各更新一次
+    const QGraphicsScene::ItemIndexMethod indexMethod = m_scene->itemIndexMethod();
+    m_scene->setItemIndexMethod(QGraphicsScene::NoIndex);
+    for (const QPoint &pos : std::as_const(availablePositions))
+        m_cellBoxes[gridIndex(pos.y() + 1, pos.x() + 1)] = nullptr;
+    for (int i = 0; i < count; i++) {
         Box* box = m_boxes[i];
-        QPoint newPos = availablePositions[i];
-        int newType = boxTypes[i];
+        const QPoint &newPos = availablePositions[i];
 
-        // 更新地图数据
-        m_map[newPos.y()][newPos.x()] = newType;
+        m_cellBoxes[gridIndex(newPos.y() + 1, newPos.x() + 1)] = box;
 
         // 更新方块属性
         box->row = newPos.y();
         box->col = newPos.x();
-        box->boxType = newType;
-
-        // 更新精灵图
-        QPixmap newSprite = getSpriteByType(newType);
-        if (!newSprite.isNull()) {
-            box->setPixmap(newSprite);
-        }
+        box->boxType = boxTypes[i];
 
         // 更新场景位置
-        QPointF scenePos = cellCenterPx(newPos.y(), newPos.x());
-        box->setPos(scenePos);
+        box->setPos(cellCenterPx(newPos.y(), newPos.x()));
+
+        // 图层模式下写格子已清掉各格状态，选中、预选、提示随箱子写回新格
+        if (m_layer) box->syncLayer();
     }
+    m_scene->setItemIndexMethod(indexMethod);
+
+    // 6. 布局整体变化，重建可消对索引
+    rebuildMoveIndex();
 
-    qDebug() << "Shuffle completed:" << m_boxes.size() << "boxes rearranged";
+    qDebug() << "Shuffle completed:" << count << "boxes rearranged";
 }
 
@@ -5,7 +5,25 @@
 #include <QString>
 #include <QPoint>
 #include <QPointF>
+#include <QPair>
+#include <QHash>
+#include <QtGlobal>
+#include <algorithm>
+#include <random>
 #include "box.h"
+#include "boardgrid.h"
+#include "profiler.h"
+#include "tracer.h"
+
+class BoardLayer;
+
+// 一次连线查询的结果，按值返回，不在 Map 上缓存任何状态
+struct MapPath {
+    bool found = false;
+    int turns = -1;
+    QVector<QPoint>  cells;     // 路径结点，padding 网格坐标 QPoint(col,row)
+    QVector<QPointF> pixels;    // 路径结点对应的场景坐标
+};
 
 // Map 类：管理 m*n 的 Box 矩阵
 class Map {
@@ -27,35 +45,85 @@ public:
     qreal getSpacing() const { return spacing; }
     QGraphicsScene* getScene() const { return m_scene; }
 
-    // 判定两 Box 是否可连接
-    bool canConnect(Box* a, Box* b);
-    bool isSolvable();
+    // 查询两 Box 之间拐弯最少、其次最短的连线；const 且可重入，棋盘不被修改期间可在多个线程同时调用
+    // （像素坐标由缓存的棋盘原点换算，不访问 QGraphicsScene）
+    MapPath findPath(Box* a, Box* b) const;
+    MapPath findPath(int r1, int c1, int r2, int c2) const;     // 原map坐标
+
+    // 判定两 Box 是否可连接（findPath 的简化版本）
+    bool canConnect(Box* a, Box* b) const { TRACE_SCOPE("Map::canConnect"); return findPath(a, b).found; }
+
+    // 连线规则：最多允许拐几次弯（默认2，范围 0 ~ MapMove::MaxTurns），修改后重建可消对索引
+    void setMaxTurns(int turns);
+    int maxTurns() const { return m_board.maxTurns(); }
+
+    // 当前棋盘的只读快照（隐式共享，O(1) 拷贝），可交给工作线程做求解、提示、死局检测
+    BoardGrid snapshot() const { return m_board; }
+    // 棋盘版本号：格子每次改动都会换新值，且不同 Map 之间不重复，用来判断快照是否已过时
+    quint64 revision() const { return m_revision; }
+
+    // 可消对索引查询（均为 O(1)）：是否还有可消对、任取一对、某两箱子当前是否可消
+    bool isSolvable() const
+    {
+        PROFILE_SCOPE("isSolvable");
+        TRACE_SCOPE("Map::isSolvable");
+        return !m_moves.isEmpty();
+    }
+    QPair<Box*, Box*> anyConnectablePair() const;
+    bool isConnectablePair(Box* a, Box* b) const;
+    int moveCount() const { return m_moves.size(); }
+
+    // 棋盘数据（类型矩阵、padding 网格、可消对索引、格子索引）占用的堆内存估算（字节），内存统计用
+    qint64 memoryBytes() const;
+
+    // 一次扫描列出全部可消对及其最少拐弯路径，写入调用方提供的缓冲（先清空，复用其容量）
+    // 可供提示、死局检测、AI、统计等共用
+    void enumerateMoves(QVector<MapMove>& out) const;
 
     QVector<Box*> m_boxes;            // 存储生成的 Box实例
-    QVector<QVector<int>> m_map;      // 存储类型编号矩阵（二维数组）
+    QVector<QVector<int>> m_map;      // 存储类型编号矩阵（二维数组），只读，修改请走 setCell()
     QGraphicsScene *m_scene;          // map场景
     QVector<Box*> m_tools;            // 存储生成的 tool类型 Box实例
 
-    // 存储最近一次判定成功的路径（节点坐标）（网格/像素）
-    QVector<QPoint>  m_pathCells;
-    QVector<QPointF> m_pathPixels;
-
     // 获取地图数据的常量引用（避免拷贝开销）
     const QVector<QVector<int>>& getMapData() const { return m_map; };
 
     // 设置地图数据（使用常量引用传递，避免拷贝开销）
     void setMapData(const QVector<QVector<int>>& newMapData);
+
+    // 修改单个格子的类型（-1为空），同步更新 m_map 与 padding 网格
+    void setCell(int r, int c, int type);
     int getRowCount(){ return m_rows; };
     int getColCount(){ return m_cols; };
 
     // 工具函数：坐标换算
     QPointF cellCenterPx(int r, int c) const;
+    QPoint cellAt(const QPointF& pos) const;    // 场景坐标 -> 最近的格子 QPoint(col,row)，可能在棋盘外
+
+    // 格子索引：原map坐标上的箱子/道具，棋盘外或没有时返回 nullptr，O(1)
+    Box* boxAt(int r, int c) const;
+    Box* toolAt(int r, int c) const;
+
+    // 场景坐标附近 3x3 格子里的箱子/道具，写入调用方缓冲（先清空，复用其容量）
+    // 只看 9 格，开销与棋盘大小无关；角色的碰撞与预选检测用
+    void boxesNear(const QPointF& pos, QVector<Box*>& out) const { itemsNear(pos, m_cellBoxes, out); }
+    void toolsNear(const QPointF& pos, QVector<Box*>& out) const { itemsNear(pos, m_cellTools, out); }
 
-    // 工具函数：padding
-    void padding(QVector<QVector<int>> &grid);
+    // 道具登记/注销，同步维护 m_tools 与格子索引（道具的 row/col 须已设置）
+    void addTool(Box* tool);
+    void removeTool(Box* tool);
 
-    // 重排所有方块位置
+    // 重排所有方块位置（随机数来自由种子决定的洗牌序列，同一种子下历次洗牌结果可复现）
     void shuffleBoxes();
+    // 重新设定洗牌序列的种子（默认用棋盘种子），基准测试、回放等需要固定结果时调用
+    void setShuffleSeed(quint32 seed) { m_shuffleRng.seed(seed); }
+
+    // 批量绘制模式：由一个 BoardLayer 图元画出全部箱子，Box 隐藏后只作逻辑句柄（位置、碰撞、状态）
+    void setBoardLayerEnabled(bool enabled);
+    BoardLayer* boardLayer() const { return m_layer; }
+
+    // 生成本局棋盘所用的随机种子（同一种子可复现同一棋盘）
+    quint32 seed() const { return m_seed; }
 
 private:
     int m_rows;             // 行数
@@ -63,10 +131,46 @@ private:
     int m_typeCount;        // 可用的类型数量
     int m_frameSize;        // 精灵图小块大小（正方形）
     const int spacing = m_frameSize + 15;
+    QPointF m_origin;       // 第 (0,0) 格中心的场景坐标，在 GUI 线程放置箱子时（addToScene）按场景中心算好
     QString m_spriteSheetPath;
-    int *disOrder;          // 打乱用数组
+    quint32 m_seed;         // 棋盘生成种子
+    std::mt19937 m_shuffleRng;  // 洗牌用的随机序列，构造时以 m_seed 播种
+    quint64 m_revision = 0; // 棋盘版本号，见 revision()
+
+    // 常驻的 padding 网格与行列位图，canConnect 等判定直接原地读取
+    BoardGrid m_board;
+
+    // 批量绘制图层（未启用时为 nullptr），与 Box 一样归 scene 所有
+    BoardLayer* m_layer = nullptr;
+    void syncBoardLayer();
+
+    // padding 网格坐标 -> 一维下标（传入的是 padding 后的行列）
+    int gridIndex(int r, int c) const { return m_board.index(r, c); }
 
-    // 初始化随机地图
+    // 由 m_map 整体重建 padding 网格与行列位图（初始化、读档时调用）
+    void rebuildGrid();
+
+    // 只写格子数据（m_map、网格、位图），不维护可消对索引；批量修改后需调用 rebuildMoveIndex()
+    void writeCell(int r, int c, int type);
+
+    // 可消对索引：只在格子变空/变满时更新受影响的配对，isSolvable() 与提示直接查表
+    QVector<QPair<int, int>> m_moves;   // 当前全部可消对（padding 网格下标，first < second）
+    QHash<qint64, int> m_moveSlot;      // 配对 -> 在 m_moves 中的位置，用于 O(1) 查找与删除
+    QVector<QVector<int>> m_partners;   // 每格当前可消的配对格
+    QVector<Box*> m_cellBoxes;          // padding 网格下标 -> 该格上的 Box
+    QVector<Box*> m_cellTools;          // padding 网格下标 -> 该格上的道具
+    void itemsNear(const QPointF& pos, const QVector<Box*>& cells, QVector<Box*>& out) const;
+
+    // 射线可达集合的缓冲与去重标记，重复使用避免分配
+    BoardGrid::Reach m_reach;
+
+    static qint64 moveKey(int a, int b) { return (qint64(std::min(a, b)) << 32) | std::max(a, b); }
+    void addMove(int a, int b);
+    void removeMove(int a, int b);
+    void dropMovesOf(int idx);
+    void rebuildMoveIndex();
+
+    // 初始化随机地图（逆序消除构造，保证可全部消除）
     void initMap();
 
     // 根据类型编号生成 QPixmap
@@ -74,19 +178,4 @@ private:
 
     // 工具函数：坐标换算
     QVector<QPointF> cellsToScene(const QVector<QPoint>& cells) const;
-
-    // 直连、一拐、二拐路径判定（返回路径点）
-    bool straightConnect(int r1, int c1, int r2, int c2,
-                         const QVector<QVector<int>>& grid,
-                         QVector<QPoint>& outPath) const;
-
-    bool oneTurnConnect(int r1, int c1, int r2, int c2,
-                        const QVector<QVector<int>>& grid,
-                        QVector<QPoint>& outPath) const;
-
-    bool twoTurnConnect(int r1, int c1, int r2, int c2,
-                        const QVector<QVector<int>>& grid,
-                        int rows, int cols,
-                        QVector<QPoint>& outPath) const;
-
 };
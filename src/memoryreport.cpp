@@ -0,0 +1,43 @@
+#include "memoryreport.h"
+#include "map.h"
+#include "box.h"
+#include "character.h"
+#include "effectpool.h"
+#include "spriteatlas.h"
+#include <QGraphicsScene>
+
+qint64 MemoryReport::pixmapBytes() const
+{
+    qint64 bytes = decoratedBytes;
+    for (const QPair<QString, qint64> &sheet : sheetBytes) bytes += sheet.second;
+    return bytes;
+}
+
+QStringList MemoryReport::lines() const
+{
+    const auto kb = [](qint64 bytes) { return QString::number(bytes / 1024.0, 'f', 1) + "KB"; };
+
+    QStringList out;
+    out << QString("live box %1  character %2  effects %3  items %4")
+               .arg(boxes).arg(characters).arg(transientItems).arg(sceneItems);
+    for (const QPair<QString, qint64> &sheet : sheetBytes)
+        out << QString("pixmap %1 %2").arg(sheet.first.section('/', -1), -16).arg(kb(sheet.second));
+    out << QString("pixmap %1 %2").arg("decorated", -16).arg(kb(decoratedBytes));
+    out << QString("map %1  total %2").arg(kb(mapBytes), kb(totalBytes()));
+    return out;
+}
+
+MemoryReport MemoryReport::capture(const Map* map, const QGraphicsScene* scene, const EffectPool* effects)
+{
+    MemoryReport report;
+    report.boxes = Box::liveCount();
+    report.characters = Character::liveCount();
+    if (effects) report.transientItems = effects->pathCount() + effects->textCount();
+    if (scene) report.sceneItems = scene->items().size();
+
+    const SpriteAtlas &atlas = SpriteAtlas::instance();
+    report.sheetBytes = atlas.sheetBytes();
+    report.decoratedBytes = atlas.decoratedBytes();
+    if (map) report.mapBytes = map->memoryBytes();
+    return report;
+}
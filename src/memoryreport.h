@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QPair>
+#include <QtGlobal>
+
+class Map;
+class QGraphicsScene;
+class EffectPool;
+
+// MemoryReport 结构：一局运行时的内存快照（调试面板显示，F4 导出到日志，测试里比较多局前后是否增长）
+// 存活对象数按类统计（进程内全部实例，不只是当前地图持有的），像素按图集里的源精灵图统计：
+// 箱子和角色的贴图都是图集帧的隐式共享引用，同一份像素只算一次
+struct MemoryReport {
+    int boxes = 0;              // 存活的 Box（含道具）
+    int characters = 0;         // 存活的 Character
+    int transientItems = 0;     // 连线、反馈文字等短时图元（回收池中的总数）
+    int sceneItems = 0;         // 场景中的图元总数
+
+    QVector<QPair<QString, qint64>> sheetBytes;     // 精灵图路径 -> 切好的帧像素字节
+    qint64 decoratedBytes = 0;  // 预渲染的高亮贴图
+    qint64 mapBytes = 0;        // 棋盘数据（类型矩阵、网格、可消对与格子索引）
+
+    qint64 pixmapBytes() const;
+    qint64 totalBytes() const { return pixmapBytes() + mapBytes; }
+
+    // 逐行的可读文本（字节按 KB 显示）
+    QStringList lines() const;
+
+    // 采集当前状态，各参数可为 nullptr
+    static MemoryReport capture(const Map* map, const QGraphicsScene* scene, const EffectPool* effects);
+};
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <QObject>
-#include <QTimer>
 #include <QPair>
+#include <QVector>
+#include <QHash>
+#include "gameloop.h"
+#include "timerwheel.h"
 
 class Map;
 class Box;
@@ -16,20 +19,28 @@ public:
     explicit PowerUpManager(QObject* parent = nullptr);
     ~PowerUpManager();
 
-    // 初始化，设置地图和场景
-    void initialize(Map* map, QGraphicsScene* scene);
+    // 初始化，设置地图、场景和本局的定时器时间轮（道具到时消失挂在上面，不持有）
+    void initialize(Map* map, QGraphicsScene* scene, TimerWheel* timers);
 
     QPixmap getPowerUpSprite(int powerUpType);
 
     // 生成道具：输入道具类型，在随机位置生成对应box
     void spawnPowerUp(int powerUpType);
+    // 移除道具（拾取后调用），并取消其自动消失计时
+    void removePowerUp(Box* powerUpBox);
 
     // Hint相关方法
     void activateHint();
     void deactivateHint();
+    // 箱子即将被删除：若它在当前Hint对中，撤掉另一个的高亮并放弃这一对
+    void forgetBox(Box* box);
+    // 获取一对可连接的方块（Hint 刷新时调用；无可消对时返回一对空指针）
+    QPair<Box*, Box*> getHintPair();
+
+    // 由 GameLoop 每个固定步长调用，推进 Hint 的刷新、闪烁与倒计时
+    void update(int dtMs);
 
-private slots:
-    void onHintTimeout();
+private:
     void updateHintPair();
     void toggleHintBlink();
 
@@ -37,19 +48,21 @@ private:
     Map* gameMap = nullptr;
     QGraphicsScene* gameScene = nullptr;
 
+    TimerWheel* sessionTimers = nullptr;
+
+    // 场上道具及其自动消失定时器（游戏时间）
+    const int powerUpLifetimeMs = 10000;
+    QHash<Box*, TimerWheel::Handle> powerUpTimers;
+
     // Hint相关成员变量
-    QTimer* hintTimer = nullptr;
-    QTimer* hintUpdateTimer = nullptr;
+    const int hintDurationMs = 10000;  // Hint 持续时长
+    int hintRemainingMs = 0;           // Hint 剩余时长（游戏时间）
+    Cadence hintCadence{500};          // 每0.5秒刷新一次Hint对并切换闪烁
     QPair<Box*, Box*> currentHintPair;
     bool isHintActive = false;
-    QTimer* hintBlinkTimer = nullptr;  // 闪烁定时器
     bool isHintBlinking = false;       // 闪烁状态标志
     int blinkCount = 0;                // 闪烁计数
 
     // 道具精灵图相关
     QString powerUpSpriteSheetPath = ":/assets/powerups.png";
-    const int powerUpFrameSize = 32;
-
-    // 获取一对可连接的方块
-    QPair<Box*, Box*> getHintPair();
 };
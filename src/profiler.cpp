@@ -0,0 +1,105 @@
+#include "profiler.h"
+#include <QFile>
+#include <QTextStream>
+#include <cstring>
+
+Profiler& Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+int Profiler::section(const char* name)
+{
+    for (int i = 0; i < m_sections.size(); ++i)
+        if (std::strcmp(m_sections[i].name, name) == 0) return i;
+
+    Section s;
+    s.name = name;
+    s.window.reserve(kWindow);
+    m_sections.append(s);
+    return m_sections.size() - 1;
+}
+
+void Profiler::record(int section, qint64 ns)
+{
+    Section &s = m_sections[section];
+    if (s.window.size() < kWindow) {
+        s.window.append(ns);
+    } else {
+        s.window[s.next] = ns;
+        s.next = (s.next + 1) % kWindow;
+    }
+    ++s.count;
+    s.totalNs += ns;
+    s.maxNs = qMax(s.maxNs, ns);
+
+    // 桶 k 收 [2^(k-1), 2^k) 微秒，桶 0 收不足 1 微秒
+    qint64 us = ns / 1000;
+    int bucket = 0;
+    while (us > 0 && bucket < kBuckets - 1) {
+        us >>= 1;
+        ++bucket;
+    }
+    ++s.buckets[bucket];
+}
+
+QString Profiler::sectionName(int section) const
+{
+    return QString::fromLatin1(m_sections[section].name);
+}
+
+Profiler::Stats Profiler::stats(int section) const
+{
+    const Section &s = m_sections[section];
+    Stats result;
+    result.count = s.count;
+    if (s.window.isEmpty()) return result;
+
+    qint64 sum = 0;
+    qint64 max = 0;
+    for (qint64 ns : s.window) {
+        sum += ns;
+        max = qMax(max, ns);
+    }
+    const int last = s.window.size() < kWindow ? s.window.size() - 1 : (s.next + kWindow - 1) % kWindow;
+    result.lastMs = s.window[last] / 1e6;
+    result.meanMs = sum / 1e6 / s.window.size();
+    result.maxMs = max / 1e6;
+    return result;
+}
+
+void Profiler::dumpHistograms(QTextStream& out) const
+{
+    for (const Section &s : m_sections) {
+        out << s.name << ": samples " << s.count
+            << " mean " << (s.count ? s.totalNs / 1e6 / s.count : 0.0) << "ms"
+            << " max " << s.maxNs / 1e6 << "ms\n";
+        for (int k = 0; k < kBuckets; ++k) {
+            if (!s.buckets[k]) continue;
+            const qint64 lo = k == 0 ? 0 : (qint64(1) << (k - 1));
+            if (k == kBuckets - 1)
+                out << "  >= " << lo << "us\t" << s.buckets[k] << "\n";
+            else
+                out << "  " << lo << "-" << (qint64(1) << k) << "us\t" << s.buckets[k] << "\n";
+        }
+    }
+}
+
+bool Profiler::dumpHistograms(const QString& path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+    QTextStream out(&file);
+    dumpHistograms(out);
+    return true;
+}
+
+void Profiler::reset()
+{
+    for (Section &s : m_sections) {
+        const char* name = s.name;
+        s = Section();
+        s.name = name;
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QVector>
+#include <QString>
+#include <QtGlobal>
+
+class QTextStream;
+
+// 调试构建默认开启分节计时；发布构建下 PROFILE_SCOPE 展开为空语句，
+// 需要时可用 DEFINES += GAME_PROFILING 在发布构建里强制开启
+#if !defined(QT_NO_DEBUG) && !defined(GAME_PROFILING)
+#define GAME_PROFILING
+#endif
+
+// Profiler 类：按名字分节统计耗时（只在 GUI 线程使用）
+// 每节保留最近 kWindow 个样本给调试面板算滚动均值/最大值，
+// 另按 2 的幂（微秒）分桶累计整个进程的直方图，退出时可导出
+class Profiler {
+public:
+    static Profiler& instance();
+
+    static constexpr int kWindow = 120;
+    static constexpr int kBuckets = 24;     // [0,1us) [1,2us) [2,4us) ... 最后一桶 >= 2^22us
+
+    static constexpr bool isEnabled()
+    {
+#ifdef GAME_PROFILING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // 最近 kWindow 个样本的统计
+    struct Stats {
+        qint64 count = 0;       // 进程内累计样本数
+        double lastMs = 0;
+        double meanMs = 0;
+        double maxMs = 0;
+    };
+
+    // 按名字查找一节，没有则登记（name 须为字符串字面量），返回编号；宏里用静态变量缓存
+    int section(const char* name);
+    void record(int section, qint64 ns);
+
+    int sectionCount() const { return m_sections.size(); }
+    QString sectionName(int section) const;
+    Stats stats(int section) const;
+
+    // 全部分节的直方图写成文本：每节一段，每行“区间 样本数”
+    void dumpHistograms(QTextStream& out) const;
+    bool dumpHistograms(const QString& path) const;
+
+    void reset();
+
+private:
+    Profiler() = default;
+
+    struct Section {
+        const char* name = nullptr;
+        QVector<qint64> window;     // 最近的样本（环形）
+        int next = 0;
+        qint64 count = 0;
+        qint64 totalNs = 0;
+        qint64 maxNs = 0;
+        qint64 buckets[kBuckets] = {};
+    };
+    QVector<Section> m_sections;
+};
+
+// 作用域计时：析构时把经过的时间记到对应分节
+class ProfileScope {
+public:
+    explicit ProfileScope(int section) : m_section(section) { m_timer.start(); }
+    ~ProfileScope() { Profiler::instance().record(m_section, m_timer.nsecsElapsed()); }
+
+private:
+    int m_section;
+    QElapsedTimer m_timer;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#ifdef GAME_PROFILING
+// 计时到当前作用域结束
+#define PROFILE_SCOPE(name) \
+    static const int PROFILE_CONCAT(profileSection_, __LINE__) = Profiler::instance().section(name); \
+    const ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(PROFILE_CONCAT(profileSection_, __LINE__))
+// 直接记一个样本（如两帧之间的间隔）
+#define PROFILE_SAMPLE(name, ns) \
+    do { \
+        static const int profileSection = Profiler::instance().section(name); \
+        Profiler::instance().record(profileSection, (ns)); \
+    } while (false)
+#else
+#define PROFILE_SCOPE(name) do {} while (false)
+#define PROFILE_SAMPLE(name, ns) do {} while (false)
+#endif
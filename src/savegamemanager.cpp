@@ -2,6 +2,7 @@
 #include "map.h"
 #include "character.h"
 #include "score.h"
+#include "tracer.h"
 #include <QFile>
 #include <QDataStream>
 #include <QMessageBox>
@@ -15,6 +16,7 @@ bool SaveGameManager::saveGame(const QString &filename,
                                QVector<Character*> &characters,
                                int countdownTime)
 {
+    TRACE_SCOPE("SaveGameManager::saveGame");
     QFile file(filename);
     if (!file.open(QIODevice::WriteOnly)) {
         emit errorOccurred(tr("无法创建存档文件: %1").arg(file.errorString()));
@@ -54,6 +56,7 @@ bool SaveGameManager::loadGame(const QString &filename,
                                QVector<Character*> &characters,
                                int &countdownTime)
 {
+    TRACE_SCOPE("SaveGameManager::loadGame");
     // 以只读模式打开
     QFile file(filename);   // 创建文件QFile类对象file，关联到传入的filename
     if (!file.open(QIODevice::ReadOnly)) {
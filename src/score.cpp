@@ -1,6 +1,9 @@
 #include "score.h"
 #include <QString>
-#include <QGraphicsDropShadowEffect>
+#include <QPainter>
+#include <QPainterPath>
+#include <QFontMetrics>
+#include <QTextDocument>
 
 Score::Score(QGraphicsItem* parent)
     : QGraphicsTextItem(parent), score(0)
@@ -9,13 +12,6 @@ Score::Score(QGraphicsItem* parent)
     setFont(QFont("Consolas", 16, QFont::Bold));
     setZValue(150);
     updateText();
-
-    //描边
-    QGraphicsDropShadowEffect* outline = new QGraphicsDropShadowEffect(this);
-    outline->setColor(Qt::black);       // 描边颜色
-    outline->setBlurRadius(8);          // 控制描边粗细（3-5px最佳）
-    outline->setOffset(0, 0);           // 必须设为0才能居中描边
-    setGraphicsEffect(outline);
 }
 
 void Score::increase(int delta)
@@ -42,5 +38,33 @@ int Score::getScore() const
 
 void Score::updateText()
 {
-    setPlainText(QString("Score：%1").arg(score));
+    const QString text = QString("Score：%1").arg(score);
+    if (text == toPlainText() && !rendered.isNull()) return;
+    setPlainText(text);
+    renderText();
+}
+
+// 描边：文字轮廓先用黑色粗笔描一圈，再填充文字颜色；位置与 QGraphicsTextItem 自己排版的一致
+void Score::renderText()
+{
+    const QRectF bounds = boundingRect();
+    rendered = QPixmap(bounds.size().toSize());
+    rendered.fill(Qt::transparent);
+
+    const qreal margin = document()->documentMargin();
+    QPainterPath path;
+    path.addText(margin, margin + QFontMetrics(font()).ascent(), font(), toPlainText());
+
+    QPainter painter(&rendered);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.strokePath(path, QPen(Qt::black, 4, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));   // 描边粗细
+    painter.fillPath(path, defaultTextColor());
+    update();
+}
+
+void Score::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    painter->drawPixmap(boundingRect().topLeft(), rendered);
 }
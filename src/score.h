@@ -2,6 +2,7 @@
 
 #include <QGraphicsTextItem>
 #include <QFont>
+#include <QPixmap>
 
 class Score : public QGraphicsTextItem
 {
@@ -14,6 +15,11 @@ public:
     int getScore() const;           // 获取当前分数
     void updateText();
 
+    // 直接画缓存好的描边文字，不走 QGraphicsEffect
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+
 private:
     int score;
+    QPixmap rendered;               // 描边文字贴图，只在文字变化时重新生成
+    void renderText();
 };
@@ -0,0 +1,199 @@
+#include "spriteatlas.h"
+#include <QDebug>
+#include <QImage>
+#include <QPainter>
+#include <algorithm>
+
+namespace {
+
+// 已知精灵图的帧几何：单帧宽高、右下角空位数；行列数由图片尺寸推出
+struct SheetInfo {
+    const char* path;
+    int frameWidth;
+    int frameHeight;
+    int skipLast;
+};
+
+const SheetInfo kSheets[] = {
+    { ":/assets/ingredient.png", 26, 26, 8 },   // 精灵图ingridient：10x7，右下角8个为空，共62帧
+    { ":/assets/recipe.png",     26, 26, 6 },   // 精灵图recipe：10x17，右下角6个为空，共164帧
+    { ":/assets/powerups.png",   32, 32, 0 },   // 道具：3帧横排
+    { ":/assets/sprites0.png",   64, 64, 0 },   // 角色：4列方向 x 3行动画帧
+    { ":/assets/sprites1.png",   64, 64, 0 },
+};
+
+// 对 alpha 通道做三遍盒式模糊（近似高斯），radius 为总模糊半径
+void blurAlpha(QVector<int>& alpha, int w, int h, int radius)
+{
+    const int r = qMax(1, radius / 3);
+    const int window = 2 * r + 1;
+    QVector<int> tmp(alpha.size());
+    for (int pass = 0; pass < 3; ++pass) {
+        // 横向
+        for (int y = 0; y < h; ++y) {
+            const int* row = alpha.constData() + y * w;
+            int sum = 0;
+            for (int x = -r; x <= r; ++x) sum += row[qBound(0, x, w - 1)];
+            for (int x = 0; x < w; ++x) {
+                tmp[y * w + x] = sum / window;
+                sum += row[qMin(w - 1, x + r + 1)] - row[qMax(0, x - r)];
+            }
+        }
+        // 纵向
+        for (int x = 0; x < w; ++x) {
+            int sum = 0;
+            for (int y = -r; y <= r; ++y) sum += tmp[qBound(0, y, h - 1) * w + x];
+            for (int y = 0; y < h; ++y) {
+                alpha[y * w + x] = sum / window;
+                sum += tmp[qMin(h - 1, y + r + 1) * w + x] - tmp[qMax(0, y - r) * w + x];
+            }
+        }
+    }
+}
+
+} // namespace
+
+SpriteAtlas& SpriteAtlas::instance()
+{
+    static SpriteAtlas atlas;
+    return atlas;
+}
+
+// 解码一张精灵图并按元数据切帧；未登记的图片整张作为一帧
+static SpriteAtlas::Sheet loadSheet(const QString& path)
+{
+    SpriteAtlas::Sheet sheet;
+    QPixmap image(path);
+    if (image.isNull()) {
+        if (!path.isEmpty()) qWarning() << "Failed to load sprite sheet:" << path;
+        return sheet;
+    }
+
+    QSize frame = image.size();
+    int skipLast = 0;
+    for (const SheetInfo &info : kSheets) {
+        if (path == QLatin1String(info.path)) {
+            frame = QSize(info.frameWidth, info.frameHeight);
+            skipLast = info.skipLast;
+            break;
+        }
+    }
+
+    sheet.frameSize = frame;
+    sheet.columns = image.width() / frame.width();
+    const int rows = image.height() / frame.height();
+    const int count = qMax(0, sheet.columns * rows - skipLast);
+    sheet.frames.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const int row = i / sheet.columns;
+        const int col = i % sheet.columns;
+        sheet.frames.append(image.copy(col * frame.width(), row * frame.height(),
+                                       frame.width(), frame.height()));
+    }
+    return sheet;
+}
+
+// 首次访问时解码，之后直接查表（加载失败也记录下来，不反复尝试）
+const SpriteAtlas::Sheet& SpriteAtlas::sheet(const QString& path)
+{
+    if (!m_sheets.contains(path))
+        m_sheets.insert(path, loadSheet(path));
+    return m_sheets[path];
+}
+
+QPixmap SpriteAtlas::frame(const QString& path, int index)
+{
+    const Sheet &s = sheet(path);
+    if (index < 0 || index >= s.frames.size()) return QPixmap();
+    return s.frames[index];
+}
+
+int SpriteAtlas::frameCount(const QString& path)
+{
+    return sheet(path).frames.size();
+}
+
+int SpriteAtlas::columns(const QString& path)
+{
+    return sheet(path).columns;
+}
+
+QSize SpriteAtlas::frameSize(const QString& path)
+{
+    return sheet(path).frameSize;
+}
+
+static qint64 pixmapBytes(const QPixmap& pixmap)
+{
+    return qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+}
+
+QVector<QPair<QString, qint64>> SpriteAtlas::sheetBytes() const
+{
+    QVector<QPair<QString, qint64>> out;
+    for (auto it = m_sheets.cbegin(); it != m_sheets.cend(); ++it) {
+        qint64 bytes = 0;
+        for (const QPixmap &frame : it.value().frames) bytes += pixmapBytes(frame);
+        out.append(qMakePair(it.key(), bytes));
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+qint64 SpriteAtlas::decoratedBytes() const
+{
+    qint64 bytes = 0;
+    for (const QPixmap &pixmap : m_decorated) bytes += pixmapBytes(pixmap);
+    return bytes;
+}
+
+// 首次请求时生成：放大贴图 -> 轮廓 alpha 模糊并着色作为光晕 -> 预选遮罩（垫在贴图后面）-> 贴图
+QPixmap SpriteAtlas::decorated(const QPixmap& sprite, qreal scale, const QColor& glow, bool darken)
+{
+    if (sprite.isNull()) return QPixmap();
+
+    const QString key = QString("%1/%2/%3/%4").arg(sprite.cacheKey()).arg(scale)
+                            .arg(glow.isValid() ? glow.rgba() : 0u).arg(darken ? 1 : 0);
+    if (m_decorated.contains(key)) return m_decorated.value(key);
+
+    const int w = qRound(sprite.width() * scale);
+    const int h = qRound(sprite.height() * scale);
+    const int pad = glow.isValid() ? GlowRadius : 0;
+    const QRect target(pad, pad, w, h);
+
+    QImage shape(w + 2 * pad, h + 2 * pad, QImage::Format_ARGB32_Premultiplied);
+    shape.fill(Qt::transparent);
+    QPainter painter(&shape);     // 不开平滑缩放，和图元 setScale 的像素风格一致
+    painter.drawPixmap(target, sprite);
+    painter.end();
+
+    QImage image(shape.size(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    if (glow.isValid()) {
+        const int iw = shape.width();
+        const int ih = shape.height();
+        QVector<int> alpha(iw * ih);
+        for (int y = 0; y < ih; ++y) {
+            const QRgb* line = reinterpret_cast<const QRgb*>(shape.constScanLine(y));
+            for (int x = 0; x < iw; ++x) alpha[y * iw + x] = qAlpha(line[x]);
+        }
+        blurAlpha(alpha, iw, ih, pad);
+
+        for (int y = 0; y < ih; ++y) {
+            QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+            for (int x = 0; x < iw; ++x) {
+                const int a = alpha[y * iw + x] * glow.alpha() / 255;
+                line[x] = qPremultiply(qRgba(glow.red(), glow.green(), glow.blue(), a));
+            }
+        }
+    }
+
+    painter.begin(&image);
+    if (darken) painter.fillRect(target, QColor(0, 0, 0, 120));
+    painter.drawImage(0, 0, shape);
+    painter.end();
+
+    const QPixmap result = QPixmap::fromImage(image);
+    m_decorated.insert(key, result);
+    return result;
+}
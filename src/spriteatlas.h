@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QString>
+#include <QPixmap>
+#include <QSize>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QColor>
+
+// SpriteAtlas 类：进程内共享的精灵图缓存（只在 GUI 线程使用）
+// 每张精灵图只解码一次，并按帧几何预先切好全部帧；frame() 返回的 QPixmap 隐式共享，
+// 同一类型的所有箱子共用同一份像素数据
+class SpriteAtlas {
+public:
+    static SpriteAtlas& instance();
+
+    // 第 index 帧（行优先编号），越界或加载失败返回空 QPixmap
+    QPixmap frame(const QString& path, int index);
+
+    // 帧几何（来自图集元数据）：有效帧数（不含右下角空位）、每行帧数、单帧尺寸
+    int frameCount(const QString& path);
+    int columns(const QString& path);
+    QSize frameSize(const QString& path);
+
+    // 预渲染的高亮外观：按 scale 放大后的贴图，glow 有效时四周加一圈 GlowRadius 的光晕，
+    // darken 时叠加预选遮罩。按 (源帧, 缩放, 颜色, 遮罩) 缓存，只在第一次请求时做模糊，
+    // 之后切换高亮只是换一张现成的图
+    static constexpr int GlowRadius = 20;
+    QPixmap decorated(const QPixmap& sprite, qreal scale, const QColor& glow, bool darken);
+
+    // 内存统计：各精灵图切好的帧占用的像素字节（按路径），以及预渲染高亮贴图的总字节
+    // 帧隐式共享，箱子、角色、图层持有的只是引用，这里每份像素只算一次
+    QVector<QPair<QString, qint64>> sheetBytes() const;
+    qint64 decoratedBytes() const;
+
+    // 释放全部缓存，下次访问时重新解码
+    void clear() { m_sheets.clear(); m_decorated.clear(); }
+
+    // 一张切好的精灵图
+    struct Sheet {
+        QSize frameSize;
+        int columns = 0;
+        QVector<QPixmap> frames;
+    };
+
+private:
+    SpriteAtlas() = default;
+
+    const Sheet& sheet(const QString& path);
+
+    QHash<QString, Sheet> m_sheets;     // 精灵图路径 -> 已切好的帧
+    QHash<QString, QPixmap> m_decorated;    // 外观键 -> 预渲染的高亮贴图
+};
@@ -0,0 +1,162 @@
+#include "timerwheel.h"
+
+TimerWheel::TimerWheel(int resolutionMs)
+    : m_resolutionMs(qMax(1, resolutionMs)),
+    m_nodes(kSentinels)
+{
+    resetSentinels();
+}
+
+void TimerWheel::resetSentinels()
+{
+    for (int i = 0; i < kSentinels; ++i) {
+        m_nodes[i].prev = i;
+        m_nodes[i].next = i;
+    }
+}
+
+void TimerWheel::link(int sentinel, int node)
+{
+    Node &s = m_nodes[sentinel];
+    Node &n = m_nodes[node];
+    n.prev = s.prev;
+    n.next = sentinel;
+    m_nodes[s.prev].next = node;
+    s.prev = node;
+}
+
+void TimerWheel::unlink(int node)
+{
+    Node &n = m_nodes[node];
+    m_nodes[n.prev].next = n.next;
+    m_nodes[n.next].prev = n.prev;
+    n.prev = n.next = -1;
+}
+
+// 按剩余刻度数选层：剩余不足 64^(l+1) 的放第 l 层，槽号取到期刻度在该层的位
+void TimerWheel::place(int node)
+{
+    const quint64 expires = m_nodes[node].expires;
+    const quint64 delta = expires > m_tick ? expires - m_tick : 0;
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (quint64(1) << (kBits * (level + 1))))
+        ++level;
+    int slot = int((expires >> (kBits * level)) & kMask);
+    if (delta >= (quint64(1) << (kBits * kLevels)))     // 超出范围的先挂在最高层，下放时再重新分配
+        slot = int(((m_tick >> (kBits * level)) + kMask) & kMask);
+    link(level * kSlots + slot, node);
+}
+
+// 低一层转完一圈时，把这一层当前槽里的定时器按剩余时间重新分配下去
+void TimerWheel::cascade(int level)
+{
+    const int sentinel = level * kSlots + int((m_tick >> (kBits * level)) & kMask);
+    int node = m_nodes[sentinel].next;
+    m_nodes[sentinel].prev = m_nodes[sentinel].next = sentinel;
+    while (node != sentinel) {
+        const int next = m_nodes[node].next;
+        place(node);
+        node = next;
+    }
+}
+
+void TimerWheel::release(int node)
+{
+    Node &n = m_nodes[node];
+    n.active = false;
+    ++n.generation;
+    n.callback = nullptr;
+    n.next = m_free;
+    m_free = node;
+    --m_pending;
+}
+
+TimerWheel::Handle TimerWheel::schedule(int delayMs, Callback callback)
+{
+    int node = m_free;
+    if (node >= 0) {
+        m_free = m_nodes[node].next;
+    } else {
+        node = m_nodes.size();
+        m_nodes.append(Node());
+    }
+
+    // 不足一个刻度的零头也算一个刻度，保证不会提前到期
+    const quint64 ticks = quint64(qMax(1, (qMax(0, delayMs) + m_accumMs + m_resolutionMs - 1) / m_resolutionMs));
+    Node &n = m_nodes[node];
+    n.expires = m_tick + ticks;
+    n.active = true;
+    n.callback = std::move(callback);
+    ++m_pending;
+    place(node);
+
+    Handle handle;
+    handle.index = node;
+    handle.generation = n.generation;
+    return handle;
+}
+
+bool TimerWheel::isPending(const Handle& handle) const
+{
+    return handle.index >= kSentinels && handle.index < m_nodes.size()
+           && m_nodes[handle.index].active && m_nodes[handle.index].generation == handle.generation;
+}
+
+bool TimerWheel::cancel(const Handle& handle)
+{
+    if (!isPending(handle)) return false;
+    unlink(handle.index);
+    release(handle.index);
+    return true;
+}
+
+// 走一个刻度：必要时逐层下放，再执行第 0 层当前槽里到期的定时器
+void TimerWheel::tickOnce()
+{
+    ++m_tick;
+    for (int level = 1; level < kLevels; ++level) {
+        if ((m_tick & ((quint64(1) << (kBits * level)) - 1)) != 0) break;
+        cascade(level);
+    }
+
+    // 先整条挪到执行链表上，回调里取消同批的定时器也能 O(1) 摘除
+    const int sentinel = int(m_tick & kMask);
+    if (m_nodes[sentinel].next == sentinel) return;
+    Node &firing = m_nodes[kFiring];
+    firing.next = m_nodes[sentinel].next;
+    firing.prev = m_nodes[sentinel].prev;
+    m_nodes[firing.next].prev = kFiring;
+    m_nodes[firing.prev].next = kFiring;
+    m_nodes[sentinel].prev = m_nodes[sentinel].next = sentinel;
+
+    while (m_nodes[kFiring].next != kFiring) {
+        const int node = m_nodes[kFiring].next;
+        unlink(node);
+        if (m_nodes[node].expires > m_tick) {       // 超出范围挂在高层的，还没到时间
+            place(node);
+            continue;
+        }
+        Callback callback = std::move(m_nodes[node].callback);
+        release(node);
+        if (callback) callback();
+    }
+}
+
+void TimerWheel::advance(int dtMs)
+{
+    m_accumMs += qMax(0, dtMs);
+    while (m_accumMs >= m_resolutionMs) {
+        m_accumMs -= m_resolutionMs;
+        tickOnce();
+    }
+}
+
+void TimerWheel::clear()
+{
+    for (int i = kSentinels; i < m_nodes.size(); ++i) {
+        if (!m_nodes[i].active) continue;
+        unlink(i);
+        release(i);
+    }
+    resetSentinels();
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+#include <functional>
+
+// TimerWheel 类：一局游戏内短时事件（道具消失、反馈文字、连线淡出等）的分层时间轮
+// 不占用任何事件循环定时器，由游戏循环按游戏时间 advance() 推进，所以暂停时一并冻结；
+// 定时器节点放在池里并串成带哨兵的双向链表，登记、取消、到期都是 O(1)（跨层下放均摊 O(1)）
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+
+    // 定时器句柄；带代数，节点被复用后旧句柄自动失效
+    struct Handle {
+        int index = -1;
+        quint32 generation = 0;
+    };
+
+    explicit TimerWheel(int resolutionMs = 33);
+
+    // delayMs 游戏时间后执行 callback（至少一个刻度之后）
+    Handle schedule(int delayMs, Callback callback);
+    // 取消尚未到期的定时器，已到期或已取消返回 false
+    bool cancel(const Handle& handle);
+    bool isPending(const Handle& handle) const;
+
+    // 推进游戏时间，到期的回调按到期先后执行；回调里可以再登记或取消定时器
+    void advance(int dtMs);
+
+    // 取消全部定时器（不执行回调），已发出的句柄全部失效
+    void clear();
+
+    int pendingCount() const { return m_pending; }
+    qint64 nowMs() const { return qint64(m_tick) * m_resolutionMs + m_accumMs; }
+
+private:
+    static constexpr int kBits = 6;
+    static constexpr int kSlots = 1 << kBits;   // 每层 64 个槽
+    static constexpr int kMask = kSlots - 1;
+    static constexpr int kLevels = 4;           // 4 层可覆盖 64^4 个刻度
+    static constexpr int kSentinels = kLevels * kSlots + 1;    // 最后一个是正在执行的链表
+    static constexpr int kFiring = kSentinels - 1;
+
+    struct Node {
+        int prev = -1;
+        int next = -1;
+        quint64 expires = 0;
+        quint32 generation = 0;
+        bool active = false;
+        Callback callback;
+    };
+
+    const int m_resolutionMs;
+    QVector<Node> m_nodes;      // 前 kSentinels 个是各槽的哨兵
+    int m_free = -1;            // 空闲节点链（经 next 串起）
+    quint64 m_tick = 0;
+    int m_accumMs = 0;
+    int m_pending = 0;
+
+    void resetSentinels();
+    void link(int sentinel, int node);
+    void unlink(int node);
+    void place(int node);
+    void cascade(int level);
+    void release(int node);
+    void tickOnce();
+};
@@ -0,0 +1,98 @@
+#include "tracer.h"
+#include <QFile>
+#include <QThread>
+#include <QCoreApplication>
+#include <chrono>
+
+Tracer& Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+qint64 Tracer::nowUs()
+{
+    static const auto origin = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+// 本线程的缓冲，首次调用时分配并登记
+Tracer::Buffer* Tracer::localBuffer()
+{
+    thread_local Buffer* buffer = nullptr;
+    if (buffer) return buffer;
+
+    std::unique_ptr<Buffer> created(new Buffer());
+    created->events.resize(kBufferEvents);
+    created->mainThread = QCoreApplication::instance()
+                          && QThread::currentThread() == QCoreApplication::instance()->thread();
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    created->tid = int(m_buffers.size()) + 1;
+    buffer = created.get();
+    m_buffers.push_back(std::move(created));
+    return buffer;
+}
+
+void Tracer::complete(const char* name, qint64 startUs, qint64 durationUs)
+{
+    Buffer* buffer = localBuffer();
+    Event &e = buffer->events[buffer->written % kBufferEvents];
+    e.name = name;
+    e.startUs = startUs;
+    e.durationUs = durationUs;
+    ++buffer->written;
+}
+
+// 每个线程的事件按写入先后输出（写满时从最旧的一条开始），另附线程名元数据
+QByteArray Tracer::toJson() const
+{
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    QByteArray json("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    bool first = true;
+    for (const std::unique_ptr<Buffer> &buffer : m_buffers) {
+        if (!first) json += ',';
+        first = false;
+        json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + QByteArray::number(buffer->tid)
+                + ",\"args\":{\"name\":\"" + (buffer->mainThread ? QByteArray("main") : "thread " + QByteArray::number(buffer->tid))
+                + "\"}}";
+
+        const quint64 begin = buffer->written > quint64(kBufferEvents) ? buffer->written - kBufferEvents : 0;
+        for (quint64 i = begin; i < buffer->written; ++i) {
+            const Event &e = buffer->events[i % kBufferEvents];
+            json += ",{\"name\":\"" + QByteArray(e.name) + "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                    + QByteArray::number(buffer->tid) + ",\"ts\":" + QByteArray::number(e.startUs)
+                    + ",\"dur\":" + QByteArray::number(e.durationUs) + "}";
+        }
+    }
+    json += "]}";
+    return json;
+}
+
+bool Tracer::writeJson(const QString& path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    return file.write(toJson()) >= 0;
+}
+
+void Tracer::clear()
+{
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    for (const std::unique_ptr<Buffer> &buffer : m_buffers)
+        buffer->written = 0;
+}
+
+int Tracer::threadCount() const
+{
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    return int(m_buffers.size());
+}
+
+int Tracer::eventCount() const
+{
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    int count = 0;
+    for (const std::unique_ptr<Buffer> &buffer : m_buffers)
+        count += int(qMin(buffer->written, quint64(kBufferEvents)));
+    return count;
+}
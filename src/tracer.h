@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Tracer 类：按 Chrome trace 事件格式记录耗时区间，导出的 JSON 可直接拖进 chrome://tracing 或 Perfetto
+// 每个线程有自己的定长环形缓冲（thread_local），记录时只写本线程的缓冲，不加锁；
+// 线程第一次记录时把缓冲登记到全局表（只这一次加锁），写满后覆盖最旧的事件
+// 未开启时 TRACE_SCOPE 只读一次原子标志
+class Tracer {
+public:
+    static Tracer& instance();
+
+    static constexpr int kBufferEvents = 1 << 16;   // 每线程最多保留的事件数
+
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // 进程内单调时钟（微秒）
+    static qint64 nowUs();
+
+    // 记一个完整区间（name 须为字符串字面量）
+    void complete(const char* name, qint64 startUs, qint64 durationUs);
+
+    // 导出与清空须在没有其他线程记录时调用（例如退出前）
+    bool writeJson(const QString& path) const;
+    QByteArray toJson() const;
+    void clear();
+
+    // 已登记的线程缓冲数与全部缓冲中保留的事件总数
+    int threadCount() const;
+    int eventCount() const;
+
+private:
+    Tracer() = default;
+
+    struct Event {
+        const char* name;
+        qint64 startUs;
+        qint64 durationUs;
+    };
+
+    struct Buffer {
+        int tid = 0;
+        bool mainThread = false;
+        std::vector<Event> events;
+        quint64 written = 0;        // 累计写入数，只由所属线程修改
+    };
+
+    Buffer* localBuffer();
+
+    std::atomic<bool> m_enabled{false};
+    mutable std::mutex m_registryMutex;
+    std::vector<std::unique_ptr<Buffer>> m_buffers;     // 线程退出后缓冲仍保留到导出
+};
+
+// 作用域区间：构造时记起点，析构时写入本线程缓冲
+class TraceScope {
+public:
+    explicit TraceScope(const char* name)
+        : m_name(Tracer::instance().isEnabled() ? name : nullptr),
+        m_startUs(m_name ? Tracer::nowUs() : 0) {}
+    ~TraceScope()
+    {
+        if (m_name) Tracer::instance().complete(m_name, m_startUs, Tracer::nowUs() - m_startUs);
+    }
+
+private:
+    const char* m_name;
+    qint64 m_startUs;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) const TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
@@ -0,0 +1,49 @@
+QT       += core widgets testlib gui concurrent
+CONFIG   += c++17 console testcase
+
+INCLUDEPATH += ../../src
+
+SOURCES += \
+    main.cpp \
+    boardbenchmark.cpp \
+    ../../src/collision.cpp \
+    ../../src/box.cpp \
+    ../../src/spriteatlas.cpp \
+    ../../src/boardgrid.cpp \
+    ../../src/boardsolver.cpp \
+    ../../src/boardgenerator.cpp \
+    ../../src/boardlayer.cpp \
+    ../../src/gameclock.cpp \
+    ../../src/gameloop.cpp \
+    ../../src/timerwheel.cpp \
+    ../../src/effectpool.cpp \
+    ../../src/profiler.cpp \
+    ../../src/tracer.cpp \
+    ../../src/character.cpp \
+    ../../src/map.cpp \
+    ../../src/powerupmanager.cpp \
+    ../../src/savegamemanager.cpp \
+    ../../src/score.cpp
+
+HEADERS += \
+    boardbenchmark.h \
+    ../../src/collision.h \
+    ../../src/box.h \
+    ../../src/spriteatlas.h \
+    ../../src/boardgrid.h \
+    ../../src/boardsolver.h \
+    ../../src/boardgenerator.h \
+    ../../src/boardlayer.h \
+    ../../src/gameclock.h \
+    ../../src/gameloop.h \
+    ../../src/timerwheel.h \
+    ../../src/effectpool.h \
+    ../../src/profiler.h \
+    ../../src/tracer.h \
+    ../../src/character.h \
+    ../../src/map.h \
+    ../../src/powerupmanager.h \
+    ../../src/savegamemanager.h \
+    ../../src/score.h
+
+RESOURCES += ../../resources/resources.qrc
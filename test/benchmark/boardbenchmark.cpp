@@ -0,0 +1,266 @@
+#include "boardbenchmark.h"
+#include "map.h"
+#include "box.h"
+#include "boardgenerator.h"
+#include "character.h"
+#include "powerupmanager.h"
+#include "timerwheel.h"
+#include <QGraphicsScene>
+#include <QKeyEvent>
+#include <cstdlib>
+
+namespace {
+
+const quint32 kBoardSeed = 20240601;    // 所有棋盘共用的固定种子
+const QString kSpriteSheet = ":/assets/ingredient.png";
+
+// 类型数随棋盘增大，每种大约 16 格，最多用到精灵图的 60 帧
+int typeCountFor(int rows, int cols)
+{
+    return qBound(4, rows * cols / 16, 60);
+}
+
+} // namespace
+
+void BoardBenchmark::addBoardSizes()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+
+    const QPoint sizes[] = { QPoint(6, 4), QPoint(10, 10), QPoint(20, 20), QPoint(50, 50), QPoint(100, 100) };
+    for (const QPoint& size : sizes)
+        QTest::newRow(qPrintable(QString("%1x%2").arg(size.y()).arg(size.x()))) << size.y() << size.x();
+}
+
+Map* BoardBenchmark::createMap(QGraphicsScene* scene, int rows, int cols, qreal emptyRatio)
+{
+    BoardGenerator generator(kBoardSeed);
+    generator.setEmptyRatio(emptyRatio);
+    const QVector<QVector<int>> cells = generator.generate(rows, cols, typeCountFor(rows, cols));
+
+    Map* map = new Map(rows, cols, typeCountFor(rows, cols), kSpriteSheet, scene, 26);
+    map->setMapData(cells);
+    map->setShuffleSeed(kBoardSeed);    // 洗牌序列也固定，各次运行结果一致
+    return map;
+}
+
+// 连线查询：直连、一次拐弯、两次拐弯各取距离最远的一对可消对，失败取同类型但连不上的一对
+void BoardBenchmark::benchCanConnect_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<int>("turns");     // -1 表示连不上
+
+    const QPoint sizes[] = { QPoint(6, 4), QPoint(10, 10), QPoint(20, 20), QPoint(50, 50), QPoint(100, 100) };
+    const char* cases[] = { "fail", "straight", "one-turn", "two-turn" };
+    for (const QPoint& size : sizes) {
+        for (int turns = -1; turns <= 2; ++turns) {
+            QTest::newRow(qPrintable(QString("%1x%2/%3").arg(size.y()).arg(size.x()).arg(cases[turns + 1])))
+                << size.y() << size.x() << turns;
+        }
+    }
+}
+
+void BoardBenchmark::benchCanConnect()
+{
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, turns);
+
+    QGraphicsScene scene;
+    Map* map = createMap(&scene, rows, cols, 0.3);
+
+    Box* a = nullptr;
+    Box* b = nullptr;
+    int best = -1;
+    if (turns >= 0) {
+        QVector<MapMove> moves;
+        map->enumerateMoves(moves);
+        for (const MapMove& move : moves) {
+            const int distance = std::abs(move.r1 - move.r2) + std::abs(move.c1 - move.c2);
+            if (move.turns != turns || distance <= best) continue;
+            best = distance;
+            a = map->boxAt(move.r1, move.c1);
+            b = map->boxAt(move.r2, move.c2);
+        }
+    } else {
+        // 按类型分组后在组内两两比较，扫遍全盘取距离最远的一对（100x100 约百万次查表）
+        QHash<int, QVector<Box*>> groups;
+        for (Box* box : std::as_const(map->m_boxes))
+            groups[map->m_map[box->row][box->col]].append(box);
+        for (const QVector<Box*>& group : std::as_const(groups)) {
+            for (int i = 0; i < group.size(); ++i) {
+                for (int j = i + 1; j < group.size(); ++j) {
+                    Box* x = group[i];
+                    Box* y = group[j];
+                    const int distance = std::abs(x->row - y->row) + std::abs(x->col - y->col);
+                    if (distance <= best || map->isConnectablePair(x, y)) continue;
+                    best = distance;
+                    a = x;
+                    b = y;
+                }
+            }
+        }
+    }
+    if (!a || !b) {
+        delete map;
+        QSKIP("No pair of this kind on this board");
+    }
+    QCOMPARE(map->canConnect(a, b), turns >= 0);
+
+    bool connected = false;
+    QBENCHMARK {
+        connected = map->canConnect(a, b);
+    }
+    QCOMPARE(connected, turns >= 0);
+
+    delete map;
+}
+
+// 可消性查询（走可消对索引）
+void BoardBenchmark::benchIsSolvable_data()
+{
+    addBoardSizes();
+}
+
+void BoardBenchmark::benchIsSolvable()
+{
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+
+    QGraphicsScene scene;
+    Map* map = createMap(&scene, rows, cols, 0.3);
+
+    bool solvable = false;
+    QBENCHMARK {
+        solvable = map->isSolvable();
+    }
+    QVERIFY(solvable);
+
+    delete map;
+}
+
+// 整盘重排（含重建可消对索引与箱子位置同步）
+void BoardBenchmark::benchShuffleBoxes_data()
+{
+    addBoardSizes();
+}
+
+void BoardBenchmark::benchShuffleBoxes()
+{
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+
+    QGraphicsScene scene;
+    Map* map = createMap(&scene, rows, cols, 0.3);
+    const int boxCount = map->m_boxes.size();
+
+    QBENCHMARK {
+        map->shuffleBoxes();
+    }
+    QCOMPARE(map->m_boxes.size(), boxCount);
+    QVERIFY(map->isSolvable());
+
+    delete map;
+}
+
+// 生成道具（扫描空位、建图元、登记自动消失定时器），每次生成后立即移除，保持棋盘不变
+void BoardBenchmark::benchSpawnPowerUp_data()
+{
+    addBoardSizes();
+}
+
+void BoardBenchmark::benchSpawnPowerUp()
+{
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+
+    QGraphicsScene scene;
+    Map* map = createMap(&scene, rows, cols, 0.3);
+    TimerWheel timers;
+    PowerUpManager powerUps;
+    powerUps.initialize(map, &scene, &timers);
+
+    QBENCHMARK {
+        powerUps.spawnPowerUp(1);
+        powerUps.removePowerUp(map->m_tools.last());
+    }
+    QCOMPARE(map->m_tools.size(), 0);
+    QCOMPARE(timers.pendingCount(), 0);
+
+    delete map;
+}
+
+// 提示对查询（PowerUpManager::getHintPair，转调 Map::anyConnectablePair）
+void BoardBenchmark::benchHintPair_data()
+{
+    addBoardSizes();
+}
+
+void BoardBenchmark::benchHintPair()
+{
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+
+    QGraphicsScene scene;
+    Map* map = createMap(&scene, rows, cols, 0.3);
+    TimerWheel timers;
+    PowerUpManager powerUps;
+    powerUps.initialize(map, &scene, &timers);
+
+    QPair<Box*, Box*> pair;
+    QBENCHMARK {
+        pair = powerUps.getHintPair();
+    }
+    QVERIFY(pair.first && pair.second);
+
+    delete map;
+}
+
+// 角色移动：沿棋盘中间一行向右走 30 个固定步长（updateMovement 的碰撞、预选与道具检测）
+// 这一行事先清空，上下两行的箱子都在碰撞范围外，角色每一步都真的在走，同时不断更换预选目标
+void BoardBenchmark::benchCharacterStep_data()
+{
+    addBoardSizes();
+}
+
+void BoardBenchmark::benchCharacterStep()
+{
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+
+    QGraphicsScene scene;
+    Map* map = createMap(&scene, rows, cols, 0.3);
+
+    const int row = rows / 2;
+    for (int c = 0; c < cols; ++c) {
+        if (Box* box = map->boxAt(row, c)) {
+            map->setCell(row, c, -1);
+            map->m_boxes.removeOne(box);
+            scene.removeItem(box);
+            delete box;
+        }
+    }
+
+    const QPointF extent = map->cellCenterPx(rows - 1, cols - 1) + QPointF(200, 200);
+    const QPointF start = map->cellCenterPx(row, 0);
+    Character character(":/assets/sprites0.png", extent);
+    character.setControls({ Qt::Key_W, Qt::Key_S, Qt::Key_A, Qt::Key_D });
+    character.setGameMap(map);
+    scene.addItem(&character);
+
+    QKeyEvent press(QEvent::KeyPress, Qt::Key_D, Qt::NoModifier);
+    QKeyEvent release(QEvent::KeyRelease, Qt::Key_D, Qt::NoModifier);
+
+    QBENCHMARK {
+        character.setPos(start);
+        character.handleKeyPress(&press);
+        for (int i = 0; i < 30; ++i) character.step(33);
+        character.handleKeyRelease(&release);
+    }
+    // 最后一轮确实走满 30 步（每步 8px），没有被箱子挡住
+    QCOMPARE(character.pos(), start + QPointF(30 * 8.0, 0));
+
+    scene.removeItem(&character);
+    delete map;
+}
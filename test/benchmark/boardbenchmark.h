@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QtTest>
+#include <QObject>
+#include <QVector>
+
+class QGraphicsScene;
+class Map;
+
+// 棋盘引擎热点路径的基准测试：每项都在 4x6 ~ 100x100 的固定种子棋盘上跑
+class BoardBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void benchCanConnect_data();
+    void benchCanConnect();
+    void benchIsSolvable_data();
+    void benchIsSolvable();
+    void benchShuffleBoxes_data();
+    void benchShuffleBoxes();
+    void benchSpawnPowerUp_data();
+    void benchSpawnPowerUp();
+    void benchHintPair_data();
+    void benchHintPair();
+    void benchCharacterStep_data();
+    void benchCharacterStep();
+
+private:
+    // 各项共用的棋盘尺寸（rows、cols 两列）
+    void addBoardSizes();
+    // 按固定种子生成可全部消除的棋盘并建好 Map
+    Map* createMap(QGraphicsScene* scene, int rows, int cols, qreal emptyRatio);
+};
@@ -0,0 +1,17 @@
+#include <QtTest>
+#include <QApplication>
+#include "boardbenchmark.h"
+
+// 未指定 -o 时同时输出到终端（txt）和 benchmark.csv（csv，便于脚本对比各版本结果）
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+
+    QStringList args = app.arguments();
+    if (!args.contains("-o")) {
+        args << "-o" << "-,txt" << "-o" << "benchmark.csv,csv";
+    }
+
+    BoardBenchmark benchmark;
+    return QTest::qExec(&benchmark, args);
+}
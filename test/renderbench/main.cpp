@@ -0,0 +1,245 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QGraphicsScene>
+#include <QGraphicsItem>
+#include <QGraphicsPathItem>
+#include <QGraphicsTextItem>
+#include <QPainter>
+#include <QPainterPath>
+#include <QImage>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QHash>
+#include <QSet>
+#include <functional>
+#include "mainwindow.h"
+#include "map.h"
+#include "box.h"
+#include "character.h"
+#include "boardgenerator.h"
+#include "effectpool.h"
+
+// 离屏渲染基准：按游戏相同的方式搭好场景（三层背景、棋盘、角色与分数、连线和反馈文字），
+// 在 offscreen 平台上反复 QGraphicsScene::render 到 QImage，输出整帧耗时/帧率，
+// 以及只显示某一图层时的单独耗时
+// 用法：renderbench [--sizes 4x6,20x20] [--states plain,hint,preselect,path,all]
+//                   [--frames 200] [--layer auto|on|off] [--csv result.csv]
+
+namespace {
+
+const quint32 kBoardSeed = 20240601;    // 与基准测试相同的固定种子
+
+// 场景中的一个图层：一组顶层图元
+struct Layer {
+    QString name;
+    QVector<QGraphicsItem*> items;
+};
+
+// 一个搭好的游戏场景
+struct GameScene {
+    QGraphicsScene* scene = nullptr;
+    Map* map = nullptr;
+    EffectPool* effects = nullptr;
+    QVector<Character*> characters;
+    QVector<Layer> layers;
+    QPair<Box*, Box*> hintPair;
+
+    ~GameScene()
+    {
+        for (Character* character : characters) {
+            scene->removeItem(character);
+            delete character;
+        }
+        delete effects;
+        delete map;
+        delete scene;       // 箱子等图元归 scene 所有
+    }
+};
+
+// 自上次调用以来新加入场景的顶层图元
+QVector<QGraphicsItem*> takeNewItems(QGraphicsScene* scene, QSet<QGraphicsItem*>& known)
+{
+    QVector<QGraphicsItem*> added;
+    for (QGraphicsItem* item : scene->items()) {
+        if (item->parentItem() || known.contains(item)) continue;
+        known.insert(item);
+        added.append(item);
+    }
+    return added;
+}
+
+// 搭建场景并按 state 设置特效状态：hint 提示对高亮（逐帧闪烁），preselect 两个角色各预选一个箱子
+// 且其中一个被选中发光，path 显示一条连线和一条反馈文字，all 为三者叠加
+void buildScene(GameScene& g, int rows, int cols, const QString& layerMode, const QString& state)
+{
+    g.scene = new QGraphicsScene();
+    QSet<QGraphicsItem*> known;
+    MainWindow::setupSceneDefaults(g.scene);
+    g.layers.append({ "background", takeNewItems(g.scene, known) });
+
+    const int typeCount = qBound(4, rows * cols / 16, 60);
+    BoardGenerator generator(kBoardSeed);
+    generator.setEmptyRatio(0.3);
+    g.map = new Map(rows, cols, typeCount, ":/assets/ingredient.png", g.scene, 26);
+    g.map->setMapData(generator.generate(rows, cols, typeCount));
+    const bool useLayer = layerMode == "on"
+                          || (layerMode == "auto" && rows * cols >= MainWindow::boardLayerMinCells);
+    g.map->setBoardLayerEnabled(useLayer);
+    g.layers.append({ "board", takeNewItems(g.scene, known) });
+
+    const QPointF mapPixSize(MainWindow::mapWidth, MainWindow::mapHeight);
+    const char* sprites[] = { ":/assets/sprites0.png", ":/assets/sprites1.png" };
+    const QPointF starts[] = { QPointF(MainWindow::mapWidth / 5, MainWindow::mapHeight / 5),
+                               QPointF(MainWindow::mapWidth / 5 * 4, MainWindow::mapHeight / 5 * 4) };
+    for (int i = 0; i < 2; ++i) {
+        Character* character = new Character(sprites[i], mapPixSize);
+        character->setPos(starts[i]);
+        character->setGameMap(g.map);
+        g.scene->addItem(character);
+        g.characters.append(character);
+    }
+    QGraphicsTextItem* countdown = g.scene->addText("Time：120");
+    countdown->setDefaultTextColor(QColorConstants::Svg::burlywood);
+    countdown->setFont(QFont("Consolas", 20, QFont::Bold));
+    countdown->setZValue(102);
+    countdown->setPos(20, 20);
+    g.layers.append({ "characters", takeNewItems(g.scene, known) });
+
+    g.effects = new EffectPool(g.scene);
+    g.hintPair = g.map->anyConnectablePair();
+    const bool all = state == "all";
+    if ((state == "preselect" || all) && g.map->m_boxes.size() >= 2) {
+        g.map->m_boxes.first()->preAct();
+        g.map->m_boxes.last()->preAct();
+        g.map->m_boxes.first()->activate();
+    }
+    if (state == "path" || all) {
+        // 取拐弯最多的一对，连线最长
+        QVector<MapMove> moves;
+        g.map->enumerateMoves(moves);
+        const MapMove* longest = nullptr;
+        for (const MapMove& move : moves)
+            if (!longest || move.turns > longest->turns) longest = &move;
+        if (longest) {
+            const MapPath path = g.map->findPath(longest->r1, longest->c1, longest->r2, longest->c2);
+            QPainterPath line(path.pixels.first());
+            for (int i = 1; i < path.pixels.size(); ++i) line.lineTo(path.pixels[i]);
+            g.effects->showPath(line);
+        }
+        g.effects->showText("+1s", Qt::green, g.characters.first()->pos());
+    }
+    g.layers.append({ "effects", takeNewItems(g.scene, known) });
+}
+
+// 渲染 frames 帧，返回平均每帧毫秒数；perFrame 在每帧渲染前调用（用于闪烁等状态切换）
+double renderFrames(QGraphicsScene* scene, QImage& image, int frames, const std::function<void(int)>& perFrame)
+{
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < frames; ++i) {
+        if (perFrame) perFrame(i);
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setRenderHint(QPainter::TextAntialiasing);
+        scene->render(&painter, QRectF(image.rect()), scene->sceneRect());
+    }
+    return timer.nsecsElapsed() / 1e6 / frames;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 没有显示也能跑：未指定平台时使用 offscreen
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Offscreen render benchmark for the game scene");
+    parser.addHelpOption();
+    parser.addOption({ "sizes", "Board sizes, rows x cols, comma separated.", "list", "4x6,10x10,20x20,50x50" });
+    parser.addOption({ "states", "Effect states: plain, hint, preselect, path, all.", "list", "plain,hint,preselect,path,all" });
+    parser.addOption({ "frames", "Frames rendered per measurement.", "count", "200" });
+    parser.addOption({ "layer", "Batched board layer: auto, on or off.", "mode", "auto" });
+    parser.addOption({ "csv", "Also write results to this CSV file.", "file" });
+    parser.process(app);
+
+    const int frames = qMax(1, parser.value("frames").toInt());
+    const QString layerMode = parser.value("layer");
+
+    QFile csvFile;
+    QTextStream csv;
+    if (parser.isSet("csv")) {
+        csvFile.setFileName(parser.value("csv"));
+        if (!csvFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            qWarning() << "Cannot open" << csvFile.fileName();
+            return 1;
+        }
+        csv.setDevice(&csvFile);
+        csv << "size,state,boardLayer,part,msPerFrame,fps\n";
+    }
+
+    QTextStream out(stdout);
+    for (const QString& size : parser.value("sizes").split(',', Qt::SkipEmptyParts)) {
+        const QStringList rc = size.split('x');
+        const int rows = rc.value(0).toInt();
+        const int cols = rc.value(1).toInt();
+        if (rows <= 0 || cols <= 0) {
+            qWarning() << "Invalid board size:" << size;
+            continue;
+        }
+
+        for (const QString& state : parser.value("states").split(',', Qt::SkipEmptyParts)) {
+            GameScene g;
+            buildScene(g, rows, cols, layerMode, state);
+            const bool useLayer = g.map->boardLayer() != nullptr;
+
+            // 提示对每帧切换一次高亮，测闪烁时的重绘开销
+            std::function<void(int)> perFrame;
+            if ((state == "hint" || state == "all") && g.hintPair.first && g.hintPair.second) {
+                perFrame = [&g](int i) {
+                    g.hintPair.first->hint(i % 2 == 0);
+                    g.hintPair.second->hint(i % 2 == 0);
+                };
+            }
+
+            QImage image(g.scene->sceneRect().size().toSize(), QImage::Format_ARGB32_Premultiplied);
+            renderFrames(g.scene, image, 5, perFrame);     // 预热：图集解码与高亮贴图缓存
+
+            QVector<QPair<QString, double>> results;
+            results.append({ "full", renderFrames(g.scene, image, frames, perFrame) });
+
+            // 单独一层：其余图层隐藏，该层图元恢复原来的可见性（空闲的池图元、图层模式下的箱子本就隐藏）
+            QHash<QGraphicsItem*, bool> visible;
+            for (const Layer& layer : g.layers)
+                for (QGraphicsItem* item : layer.items) visible.insert(item, item->isVisible());
+            auto showOnly = [&](const Layer* only) {
+                for (const Layer& layer : g.layers)
+                    for (QGraphicsItem* item : layer.items)
+                        item->setVisible(&layer == only && visible.value(item));
+            };
+            showOnly(nullptr);
+            results.append({ "empty", renderFrames(g.scene, image, frames, nullptr) });
+            for (const Layer& layer : g.layers) {
+                showOnly(&layer);
+                results.append({ layer.name, renderFrames(g.scene, image, frames,
+                                                          layer.name == "board" ? perFrame : nullptr) });
+            }
+
+            out << QString("%1 %2 (%3)").arg(size, -8).arg(state, -10).arg(useLayer ? "layer" : "items");
+            for (const auto& result : results) {
+                out << QString("  %1 %2ms").arg(result.first).arg(result.second, 0, 'f', 3);
+                if (csvFile.isOpen()) {
+                    csv << size << ',' << state << ',' << (useLayer ? 1 : 0) << ',' << result.first << ','
+                        << result.second << ',' << (result.second > 0 ? 1000.0 / result.second : 0) << '\n';
+                }
+            }
+            out << QString("  => %1 fps").arg(results.first().second > 0 ? 1000.0 / results.first().second : 0, 0, 'f', 1)
+                << Qt::endl;
+        }
+    }
+
+    return 0;
+}
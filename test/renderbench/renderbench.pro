@@ -0,0 +1,62 @@
+QT       += core widgets gui concurrent
+CONFIG   += c++17 console
+CONFIG   -= app_bundle
+
+TARGET = renderbench
+
+INCLUDEPATH += ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/mainwindow.cpp \
+    ../../src/character.cpp \
+    ../../src/path.cpp \
+    ../../src/collision.cpp \
+    ../../src/box.cpp \
+    ../../src/spriteatlas.cpp \
+    ../../src/boardgrid.cpp \
+    ../../src/boardsolver.cpp \
+    ../../src/boardgenerator.cpp \
+    ../../src/boardlayer.cpp \
+    ../../src/gameclock.cpp \
+    ../../src/gameloop.cpp \
+    ../../src/timerwheel.cpp \
+    ../../src/effectpool.cpp \
+    ../../src/profiler.cpp \
+    ../../src/tracer.cpp \
+    ../../src/gameview.cpp \
+    ../../src/debughud.cpp \
+    ../../src/memoryreport.cpp \
+    ../../src/map.cpp \
+    ../../src/powerupmanager.cpp \
+    ../../src/savegamemanager.cpp \
+    ../../src/score.cpp \
+    ../../src/startmenu.cpp
+
+HEADERS += \
+    ../../src/mainwindow.h \
+    ../../src/character.h \
+    ../../src/path.h \
+    ../../src/collision.h \
+    ../../src/box.h \
+    ../../src/spriteatlas.h \
+    ../../src/boardgrid.h \
+    ../../src/boardsolver.h \
+    ../../src/boardgenerator.h \
+    ../../src/boardlayer.h \
+    ../../src/gameclock.h \
+    ../../src/gameloop.h \
+    ../../src/timerwheel.h \
+    ../../src/effectpool.h \
+    ../../src/profiler.h \
+    ../../src/tracer.h \
+    ../../src/gameview.h \
+    ../../src/debughud.h \
+    ../../src/memoryreport.h \
+    ../../src/map.h \
+    ../../src/powerupmanager.h \
+    ../../src/savegamemanager.h \
+    ../../src/score.h \
+    ../../src/startmenu.h
+
+RESOURCES += ../../resources/resources.qrc
@@ -2,8 +2,35 @@
 #include "box.h"
 #include "collision.h"
 #include "map.h"
+#include "boardsolver.h"
+#include "boardgenerator.h"
+#include "spriteatlas.h"
+#include "boardlayer.h"
+#include "character.h"
+#include "gameloop.h"
+#include "gameclock.h"
+#include "timerwheel.h"
+#include "powerupmanager.h"
+#include "effectpool.h"
+#include "profiler.h"
+#include "tracer.h"
+#include "memoryreport.h"
+#include "mainwindow.h"
+#include "gameview.h"
 #include <QGraphicsRectItem>
+#include <QGraphicsPathItem>
+#include <QGraphicsTextItem>
+#include <QPainterPath>
+#include <QStyleOptionGraphicsItem>
+#include <QPainter>
+#include <QImage>
+#include <QKeyEvent>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
 #include <QDebug>
+#include <thread>
 
 void SimpleTest::testEuclidDistance()
 {
@@ -300,3 +327,1216 @@ void SimpleTest::testComplexCase()
     delete scene;
     qDebug() << "Complex case test passed!";
 }
+
+void SimpleTest::testConnectAfterRemoval()
+{
+    qDebug() << "Testing connection after removal...";
+
+    // 中间一列挡住了两侧的1，消除后应能直连
+    QVector<QVector<int>> testMap = {
+        { 2,  2,  2},
+        { 1,  3,  1},
+        { 2,  2,  2}
+    };
+
+    QGraphicsScene* scene = new QGraphicsScene();
+    Map map(3, 3, 3, ":/assets/ingredient.png", scene, 26);
+    map.setMapData(testMap);
+
+    Box* box1 = nullptr;
+    Box* box2 = nullptr;
+    for (Box* box : map.m_boxes) {
+        if (box->row == 1 && box->col == 0) box1 = box;
+        if (box->row == 1 && box->col == 2) box2 = box;
+    }
+
+    QVERIFY(box1 != nullptr && box2 != nullptr);
+    QVERIFY(!map.canConnect(box1, box2));
+
+    // 通过 setCell 清空中间格，padding 网格应同步更新
+    map.setCell(1, 1, -1);
+    QCOMPARE(map.getMapData()[1][1], -1);
+    QVERIFY(map.canConnect(box1, box2));
+    QCOMPARE(map.findPath(box1, box2).cells.size(), 2);
+
+    delete scene;
+    qDebug() << "Connection after removal test passed!";
+}
+
+void SimpleTest::testWideBoardConnect()
+{
+    qDebug() << "Testing wide board connection...";
+
+    // 列数超过64，行列位图需要跨多个字
+    const int rows = 3, cols = 90;
+    QVector<QVector<int>> testMap(rows, QVector<int>(cols, 2));
+    for (int j = 1; j < cols - 1; ++j) testMap[1][j] = -1;  // 中间行打通
+    testMap[1][0] = 1;
+    testMap[1][cols - 1] = 1;
+    testMap[0][70] = 3;
+
+    QGraphicsScene* scene = new QGraphicsScene();
+    Map map(rows, cols, 3, ":/assets/ingredient.png", scene, 26);
+    map.setMapData(testMap);
+
+    Box* box1 = nullptr;
+    Box* box2 = nullptr;
+    for (Box* box : map.m_boxes) {
+        if (box->row == 1 && box->col == 0) box1 = box;
+        if (box->row == 1 && box->col == cols - 1) box2 = box;
+    }
+
+    QVERIFY(box1 != nullptr && box2 != nullptr);
+    QVERIFY(map.canConnect(box1, box2));
+
+    // 在第二个字内堵住通道
+    map.setCell(1, 70, 3);
+    QVERIFY(!map.canConnect(box1, box2));
+
+    delete scene;
+    qDebug() << "Wide board connection test passed!";
+}
+
+void SimpleTest::testMoveIndexUpdates()
+{
+    qDebug() << "Testing move index updates...";
+
+    // 两个1被四周的2/3围住，2和3都只有一个，初始无解
+    QVector<QVector<int>> testMap = {
+        {-1,  2, -1, -1},
+        { 3,  1,  4,  1},
+        {-1,  5, -1, -1}
+    };
+
+    QGraphicsScene* scene = new QGraphicsScene();
+    Map map(3, 4, 5, ":/assets/ingredient.png", scene, 26);
+    map.setMapData(testMap);
+
+    QVERIFY(!map.isSolvable());
+    QCOMPARE(map.moveCount(), 0);
+
+    // 清空挡路的4，两个1可直连，索引应增量出现这一对
+    map.setCell(1, 2, -1);
+    QVERIFY(map.isSolvable());
+    QCOMPARE(map.moveCount(), 1);
+
+    QPair<Box*, Box*> hint = map.anyConnectablePair();
+    QVERIFY(hint.first != nullptr && hint.second != nullptr);
+    QVERIFY(map.isConnectablePair(hint.first, hint.second));
+    QVERIFY(map.canConnect(hint.first, hint.second));
+
+    // 消除这一对后重新无解
+    map.setCell(hint.first->row, hint.first->col, -1);
+    map.setCell(hint.second->row, hint.second->col, -1);
+    QVERIFY(!map.isSolvable());
+
+    delete scene;
+    qDebug() << "Move index update test passed!";
+}
+
+void SimpleTest::testEnumerateMoves()
+{
+    qDebug() << "Testing move enumeration...";
+
+    // 与 testTwoTurnConnect 相同的地图：1 两两可连，两个2需要两拐
+    QVector<QVector<int>> testMap = {
+        { 2,  1,  1},
+        {-1, -1, -1},
+        { 1,  1,  2}
+    };
+
+    QGraphicsScene* scene = new QGraphicsScene();
+    Map map(3, 3, 2, ":/assets/ingredient.png", scene, 26);
+    map.setMapData(testMap);
+
+    QVector<MapMove> moves;
+    map.enumerateMoves(moves);
+    QCOMPARE(moves.size(), map.moveCount());
+
+    bool foundTwoTurn = false;
+    for (const MapMove& move : moves) {
+        QCOMPARE(move.pointCount, move.turns + 2);
+        QCOMPARE(map.getMapData()[move.r1][move.c1], map.getMapData()[move.r2][move.c2]);
+        if (move.r1 == 0 && move.c1 == 0 && move.r2 == 2 && move.c2 == 2) {
+            foundTwoTurn = true;
+            QCOMPARE(move.turns, 2);
+        }
+    }
+    QVERIFY(foundTwoTurn);
+
+    // 复用线程缓冲的去重表：消掉一对后再列一次，不会沿用上一次的去重结果
+    map.setCell(0, 1, -1);
+    map.setCell(0, 2, -1);
+    map.enumerateMoves(moves);
+    QCOMPARE(moves.size(), map.moveCount());
+
+    delete scene;
+    qDebug() << "Move enumeration test passed!";
+}
+
+void SimpleTest::testMaxTurnsRule()
+{
+    qDebug() << "Testing configurable turn limit...";
+
+    // 两个2之间只有一条螺旋通道：右、下、左、下，需要拐三次
+    QVector<QVector<int>> testMap = {
+        { 0,  0,  0,  0,  0},
+        { 0,  2, -1, -1,  0},
+        { 0,  0,  0, -1,  0},
+        { 0, -1, -1, -1,  0},
+        { 0,  2,  0,  0,  0}
+    };
+
+    QGraphicsScene* scene = new QGraphicsScene();
+    Map map(5, 5, 2, ":/assets/ingredient.png", scene, 26);
+    map.setMapData(testMap);
+
+    Box* box1 = nullptr;
+    Box* box2 = nullptr;
+    for (Box* box : map.m_boxes) {
+        if (box->row == 1 && box->col == 1) box1 = box;
+        if (box->row == 4 && box->col == 1) box2 = box;
+    }
+    QVERIFY(box1 && box2);
+
+    // 默认两拐规则下不可连
+    QCOMPARE(map.maxTurns(), 2);
+    QVERIFY(!map.canConnect(box1, box2));
+    QVERIFY(!map.isConnectablePair(box1, box2));
+
+    // 放宽到三拐后可连，路径为 5 个结点，可消对索引同步更新
+    map.setMaxTurns(3);
+    QVERIFY(map.canConnect(box1, box2));
+    QCOMPARE(map.findPath(box1, box2).cells.size(), 5);
+    QVERIFY(map.isConnectablePair(box1, box2));
+
+    // 收紧到直连规则
+    map.setMaxTurns(0);
+    QVERIFY(!map.canConnect(box1, box2));
+    QVERIFY(!map.isConnectablePair(box1, box2));
+
+    delete scene;
+    qDebug() << "Turn limit test passed!";
+}
+
+void SimpleTest::testFindPathConcurrent()
+{
+    qDebug() << "Testing concurrent path queries...";
+
+    QVector<QVector<int>> testMap = {
+        { 2,  1,  1},
+        {-1, -1, -1},
+        { 1,  1,  2}
+    };
+
+    QGraphicsScene* scene = new QGraphicsScene(0, 0, 800, 600);     // 固定场景矩形，工作线程只读 Map 的缓存
+    Map map(3, 3, 2, ":/assets/ingredient.png", scene, 26);
+    map.setMapData(testMap);
+    const Map& board = map;
+
+    // 单线程结果作为基准
+    const MapPath expected = board.findPath(0, 0, 2, 2);
+    QVERIFY(expected.found);
+    QCOMPARE(expected.turns, 2);
+    QCOMPARE(expected.cells.size(), 4);
+    QCOMPARE(expected.pixels.size(), 4);
+
+    // 多个线程同时查询同一棋盘，各自拿到的路径互不干扰
+    const int threadCount = 4;
+    std::vector<int> mismatches(threadCount, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&board, &expected, &mismatches, t]() {
+            for (int i = 0; i < 200; ++i) {
+                const MapPath path = board.findPath(0, 0, 2, 2);
+                if (path.cells != expected.cells || path.pixels != expected.pixels) ++mismatches[t];
+                if (board.findPath(0, 0, 0, 1).found) ++mismatches[t];  // 类型不同
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    for (int count : mismatches) QCOMPARE(count, 0);
+
+    delete scene;
+    qDebug() << "Concurrent path query test passed!";
+}
+
+void SimpleTest::testParallelMoveSearch()
+{
+    qDebug() << "Testing parallel move search...";
+
+    // 箱子数超过并行阈值的大棋盘，6 种类型交错排布，每隔一行留空
+    const int rows = 30, cols = 40;
+    QVector<QVector<int>> testMap(rows, QVector<int>(cols, -1));
+    for (int i = 0; i < rows; i += 2)
+        for (int j = 0; j < cols; ++j)
+            testMap[i][j] = (i / 2 + j) % 6;
+
+    QGraphicsScene* scene = new QGraphicsScene();
+    Map map(rows, cols, 6, ":/assets/ingredient.png", scene, 26);
+    map.setMapData(testMap);
+
+    // 并行分组搜索与逐个枚举的结果一致
+    const BoardGrid board = map.snapshot();
+    QVector<MapMove> moves;
+    map.enumerateMoves(moves);
+    QCOMPARE(board.allMoves().size(), moves.size());
+    QCOMPARE(map.moveCount(), moves.size());
+
+    QPair<int, int> any;
+    QVERIFY(board.findAnyMove(&any));
+    QCOMPARE(board.typeAt(any.first), board.typeAt(any.second));
+    QVERIFY(board.linkable(any.first, any.second));
+
+    // 快照不随地图修改而改变
+    map.setCell(0, 0, -1);
+    QCOMPARE(board.typeAt(board.index(1, 1)), 0);
+    QCOMPARE(map.snapshot().typeAt(board.index(1, 1)), -1);
+
+    delete scene;
+    qDebug() << "Parallel move search test passed!";
+}
+
+void SimpleTest::testBoardSolver()
+{
+    qDebug() << "Testing board solver...";
+
+    BoardSolver solver;
+
+    // 与 testTwoTurnConnect 相同的地图：先消 1 再消 2，可以全部消除
+    QVector<QVector<int>> testMap = {
+        {2, 1, 1},
+        {-1, -1, -1},
+        {1, 1, 2}
+    };
+    BoardGrid board(testMap);
+    BoardSolver::Result result = solver.solve(board);
+    QVERIFY(result.finished);
+    QVERIFY(result.solvable);
+    QCOMPARE(result.solution.size(), 3);
+
+    // 按给出的顺序在副本上逐步消除，每一步都必须可连
+    for (const QPair<QPoint, QPoint>& step : result.solution) {
+        const int a = board.index(step.first.y() + 1, step.first.x() + 1);
+        const int b = board.index(step.second.y() + 1, step.second.x() + 1);
+        QVERIFY(board.typeAt(a) != -1);
+        QCOMPARE(board.typeAt(a), board.typeAt(b));
+        QVERIFY(board.linkable(a, b));
+        board.set(step.first.y() + 1, step.first.x() + 1, -1);
+        board.set(step.second.y() + 1, step.second.x() + 1, -1);
+    }
+
+    // 某类型数量为奇数，直接判定无解
+    QVector<QVector<int>> oddMap = {{1, 1, 1}};
+    result = solver.solve(BoardGrid(oddMap));
+    QVERIFY(result.finished);
+    QVERIFY(!result.solvable);
+
+    // 一拐规则下对角的两对互相挡住：无可消对，无解
+    QVector<QVector<int>> blockedMap = {
+        {1, 2, -1},
+        {2, 1, -1},
+        {-1, -1, -1}
+    };
+    BoardGrid blocked(blockedMap);
+    blocked.setMaxTurns(1);
+    result = solver.solve(blocked);
+    QVERIFY(result.finished);
+    QVERIFY(!result.solvable);
+
+    // 直连规则下 3 可以消，但之后 1、2 交错挡住：有可消对却消不完
+    QVector<QVector<int>> deadEndMap = {{1, 2, 1, 2, 3, 3}};
+    BoardGrid deadEnd(deadEndMap);
+    deadEnd.setMaxTurns(0);
+    QVERIFY(deadEnd.findAnyMove());
+    result = solver.solve(deadEnd);
+    QVERIFY(result.finished);
+    QVERIFY(!result.solvable);
+
+    qDebug() << "Board solver test passed!";
+}
+
+void SimpleTest::testBoardSolverBudget()
+{
+    qDebug() << "Testing board solver budget...";
+
+    // 与游戏内可消性检查相同的时限；同一个求解器反复使用，置换表靠盐值失效而不清空
+    BoardSolver solver;
+    solver.setTimeLimit(20);
+
+    for (int typeCount : {4, 8, 12}) {
+        for (quint32 seed = 1; seed <= 5; ++seed) {
+            BoardGenerator generator(seed);
+            generator.setEmptyRatio(1.0 / (typeCount + 1));
+            BoardGrid board(generator.generate(10, 15, typeCount));
+
+            // 生成的棋盘一定可解，且须在时限内得出结论；再解一次，上一次的表项不能影响结果
+            BoardSolver::Result result = solver.solve(board);
+            QVERIFY(result.finished);
+            QVERIFY(result.solvable);
+            const BoardSolver::Result again = solver.solve(board);
+            QVERIFY(again.finished);
+            QCOMPARE(again.solvable, result.solvable);
+            QCOMPARE(again.solution, result.solution);
+
+            // 边玩边查：每消一对都检查一次，同样要在时限内结束
+            for (int step = 0; step < 10; ++step) {
+                const QVector<QPair<int, int>> moves = board.allMoves();
+                if (moves.isEmpty()) break;
+                const QPair<int, int> move = moves.first();
+                board.set(move.first / board.stride(), move.first % board.stride(), -1);
+                board.set(move.second / board.stride(), move.second % board.stride(), -1);
+                QVERIFY(solver.solve(board).finished);
+            }
+        }
+    }
+
+    qDebug() << "Board solver budget test passed!";
+}
+
+void SimpleTest::testBoardGenerator()
+{
+    qDebug() << "Testing board generator...";
+
+    const int rows = 10, cols = 15, typeCount = 8;
+    BoardGenerator generator(2024);
+    generator.setEmptyRatio(1.0 / (typeCount + 1));
+    const QVector<QVector<int>> board = generator.generate(rows, cols, typeCount);
+
+    // 同一种子生成的棋盘相同
+    BoardGenerator again(2024);
+    again.setEmptyRatio(1.0 / (typeCount + 1));
+    QCOMPARE(again.generate(rows, cols, typeCount), board);
+
+    // 各类型成对出现、数量均衡，恰好 typeCount 种互不相同的帧
+    QHash<int, int> counts;
+    int tiles = 0;
+    for (const QVector<int>& row : board) {
+        for (int type : row) {
+            if (type == -1) continue;
+            ++counts[type];
+            ++tiles;
+        }
+    }
+    QCOMPARE(counts.size(), typeCount);
+    int minCount = rows * cols, maxCount = 0;
+    for (int count : counts) {
+        QCOMPARE(count % 2, 0);
+        minCount = qMin(minCount, count);
+        maxCount = qMax(maxCount, count);
+    }
+    QVERIFY(maxCount - minCount <= 2);
+
+    // 按给出的消除顺序回放，每一步都可连，最后棋盘清空
+    BoardGrid grid(board);
+    for (const QPair<QPoint, QPoint>& step : generator.removalOrder()) {
+        const int a = grid.index(step.first.y() + 1, step.first.x() + 1);
+        const int b = grid.index(step.second.y() + 1, step.second.x() + 1);
+        QCOMPARE(grid.typeAt(a), grid.typeAt(b));
+        QVERIFY(grid.linkable(a, b));
+        grid.set(step.first.y() + 1, step.first.x() + 1, -1);
+        grid.set(step.second.y() + 1, step.second.x() + 1, -1);
+    }
+    QCOMPARE(generator.removalOrder().size() * 2, tiles);
+    QVERIFY(!grid.findAnyMove());
+
+    // 求解器同样判定可解
+    BoardSolver solver;
+    QVERIFY(solver.solve(BoardGrid(board)).solvable);
+
+    qDebug() << "Board generator test passed!";
+}
+
+void SimpleTest::testShuffleKeepsMove()
+{
+    qDebug() << "Testing shuffle keeps a move...";
+
+    // 直连规则下稀疏的 3 对箱子，随机打乱后经常无可消对，需要原地修复
+    QVector<QVector<int>> testMap = {
+        {1, -1, -1, -1, -1, -1},
+        {-1, -1, 2, -1, -1, -1},
+        {-1, -1, -1, -1, 3, -1},
+        {-1, 3, -1, -1, -1, -1},
+        {-1, -1, -1, 2, -1, -1},
+        {-1, -1, -1, -1, -1, 1}
+    };
+
+    QGraphicsScene* scene = new QGraphicsScene();
+    Map map(6, 6, 3, ":/assets/ingredient.png", scene, 26);
+    map.setMaxTurns(0);
+    map.setMapData(testMap);
+
+    // 道具格不参与打乱
+    Box* tool = new Box(QPointF(0, 0), ":/assets/ingredient.png", scene);
+    tool->row = 0;
+    tool->col = 1;
+    map.m_tools.append(tool);
+
+    for (int round = 0; round < 50; ++round) {
+        map.shuffleBoxes();
+        QVERIFY(map.isSolvable());
+        QCOMPARE(map.m_map[0][1], -1);
+
+        // 方块与类型矩阵一致，每种类型仍是 2 个
+        QHash<int, int> counts;
+        for (Box* box : map.m_boxes) {
+            QCOMPARE(map.m_map[box->row][box->col], box->boxType);
+            ++counts[box->boxType];
+        }
+        QCOMPARE(counts.size(), 3);
+        for (int count : counts) QCOMPARE(count, 2);
+    }
+
+    // 洗牌序列由种子决定：同一棋盘、同一种子，历次洗牌结果相同
+    Map first(6, 6, 3, ":/assets/ingredient.png", scene, 26);
+    Map second(6, 6, 3, ":/assets/ingredient.png", scene, 26);
+    first.setMapData(testMap);
+    second.setMapData(testMap);
+    first.setShuffleSeed(7);
+    second.setShuffleSeed(7);
+    for (int round = 0; round < 3; ++round) {
+        first.shuffleBoxes();
+        second.shuffleBoxes();
+        QCOMPARE(first.getMapData(), second.getMapData());
+    }
+
+    delete scene;
+    qDebug() << "Shuffle keeps move test passed!";
+}
+
+void SimpleTest::testSpriteAtlas()
+{
+    qDebug() << "Testing sprite atlas...";
+
+    SpriteAtlas& atlas = SpriteAtlas::instance();
+    const QString ingredient = ":/assets/ingredient.png";
+
+    // 帧几何来自图集元数据
+    QCOMPARE(atlas.frameCount(ingredient), 62);
+    QCOMPARE(atlas.columns(ingredient), 10);
+    QCOMPARE(atlas.frameSize(ingredient), QSize(26, 26));
+    QCOMPARE(atlas.frameCount(":/assets/powerups.png"), 3);
+    QCOMPARE(atlas.frameCount(":/assets/sprites0.png"), 12);
+
+    // 同一帧多次获取共享同一份像素数据
+    const QPixmap a = atlas.frame(ingredient, 5);
+    const QPixmap b = atlas.frame(ingredient, 5);
+    QVERIFY(!a.isNull());
+    QCOMPARE(a.size(), QSize(26, 26));
+    QCOMPARE(a.cacheKey(), b.cacheKey());
+    QVERIFY(a.cacheKey() != atlas.frame(ingredient, 6).cacheKey());
+
+    // 越界帧与不存在的图片返回空贴图
+    QVERIFY(atlas.frame(ingredient, 62).isNull());
+    QVERIFY(atlas.frame(":/assets/missing.png", 0).isNull());
+
+    // 地图上同类型的箱子共用同一份贴图
+    QVector<QVector<int>> testMap = {
+        {3, 3, 7},
+        {7, 3, 3}
+    };
+    QGraphicsScene* scene = new QGraphicsScene();
+    Map map(2, 3, 2, ingredient, scene, 26);
+    map.setMapData(testMap);
+    QHash<int, qint64> keys;
+    for (Box* box : map.m_boxes) {
+        const int type = map.m_map[box->row][box->col];
+        if (!keys.contains(type)) keys.insert(type, box->pixmap().cacheKey());
+        QCOMPARE(box->pixmap().cacheKey(), keys.value(type));
+    }
+    QCOMPARE(keys.size(), 2);
+
+    delete scene;
+    qDebug() << "Sprite atlas test passed!";
+}
+
+void SimpleTest::testBoardLayer()
+{
+    qDebug() << "Testing board layer...";
+
+    QVector<QVector<int>> testMap = {
+        {1, 2, -1, 3},
+        {3, -1, 2, 1}
+    };
+    QGraphicsScene* scene = new QGraphicsScene(0, 0, 800, 600);
+    Map map(2, 4, 3, ":/assets/ingredient.png", scene, 26);
+    map.setMapData(testMap);
+    map.setBoardLayerEnabled(true);
+
+    // 图层与类型矩阵一致，Box 隐藏只作逻辑句柄
+    BoardLayer* layer = map.boardLayer();
+    QVERIFY(layer);
+    for (int i = 0; i < 2; ++i)
+        for (int j = 0; j < 4; ++j)
+            QCOMPARE(layer->tileAt(i, j), testMap[i][j]);
+    for (Box* box : map.m_boxes) {
+        QVERIFY(!box->isVisible());
+        QCOMPARE(box->layer, layer);
+    }
+
+    // Box 的状态变化写到图层对应格子
+    Box* box = map.m_boxes.first();
+    box->activate();
+    box->preAct();
+    QCOMPARE(layer->cellFlags(box->row, box->col), int(BoardLayer::Selected | BoardLayer::Preselected));
+    box->hint(true);
+    box->deactivate();
+    box->npreAct();
+    QCOMPARE(layer->cellFlags(box->row, box->col), int(BoardLayer::Hinted));
+    box->hint(false);
+    QCOMPARE(layer->cellFlags(box->row, box->col), 0);
+
+    // 消除时格子清空
+    map.setCell(box->row, box->col, -1);
+    QCOMPARE(layer->tileAt(box->row, box->col), -1);
+    map.m_boxes.removeOne(box);
+
+    // 暴露区域只覆盖一格时只画这一格
+    QImage image(800, 600, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    QStyleOptionGraphicsItem option;
+    option.exposedRect = layer->boundingRect();
+    layer->paint(&painter, &option);
+    QCOMPARE(layer->lastPaintedCells(), 5);
+
+    const QPointF center = map.cellCenterPx(1, 3);
+    option.exposedRect = QRectF(center.x() - 1, center.y() - 1, 2, 2);
+    layer->paint(&painter, &option);
+    QCOMPARE(layer->lastPaintedCells(), 1);
+    painter.end();
+
+    // 洗牌改写全部格子后，选中与预选状态跟着箱子到新格
+    Box* selected = map.m_boxes.first();
+    selected->activate();
+    selected->preAct();
+    map.shuffleBoxes();
+    QCOMPARE(layer->tileAt(selected->row, selected->col),
+             map.getMapData()[selected->row][selected->col]);
+    QCOMPARE(layer->cellFlags(selected->row, selected->col),
+             int(BoardLayer::Selected | BoardLayer::Preselected));
+    int flagged = 0;
+    for (int i = 0; i < 2; ++i)
+        for (int j = 0; j < 4; ++j)
+            if (layer->cellFlags(i, j)) ++flagged;
+    QCOMPARE(flagged, 1);
+    selected->deactivate();
+    selected->npreAct();
+
+    // 关闭后恢复逐个 Box 绘制
+    map.setBoardLayerEnabled(false);
+    QVERIFY(!map.boardLayer());
+    for (Box* b : map.m_boxes) {
+        QVERIFY(b->isVisible());
+        QVERIFY(!b->layer);
+    }
+
+    delete scene;
+    qDebug() << "Board layer test passed!";
+}
+
+void SimpleTest::testHighlightLooks()
+{
+    qDebug() << "Testing cached highlight looks...";
+
+    SpriteAtlas& atlas = SpriteAtlas::instance();
+    const QPixmap sprite = atlas.frame(":/assets/ingredient.png", 4);
+    QVERIFY(!sprite.isNull());
+
+    // 同一外观只生成一次，之后拿到的是同一张图
+    const QPixmap glow = atlas.decorated(sprite, 2, Qt::yellow, false);
+    QCOMPARE(glow.cacheKey(), atlas.decorated(sprite, 2, Qt::yellow, false).cacheKey());
+    QCOMPARE(glow.size(), sprite.size() * 2 + QSize(2, 2) * SpriteAtlas::GlowRadius);
+    QVERIFY(glow.cacheKey() != atlas.decorated(sprite, 2, Qt::red, false).cacheKey());
+    QCOMPARE(atlas.decorated(sprite, 1.5, QColor(), true).size(), sprite.size() * 1.5);
+
+    // 高亮切换只是换贴图，不挂特效
+    QGraphicsScene* scene = new QGraphicsScene(0, 0, 800, 600);
+    Box* box = new Box(QPointF(100, 100), "", scene);
+    box->setSprite(sprite);
+    box->activate();
+    QVERIFY(!box->graphicsEffect());
+    QCOMPARE(box->pixmap().cacheKey(), glow.cacheKey());
+    box->preAct();
+    box->npreAct();
+    QCOMPARE(box->pixmap().cacheKey(), glow.cacheKey());
+    box->deactivate();
+    QVERIFY(!box->graphicsEffect());
+    QCOMPARE(box->pixmap().cacheKey(), sprite.cacheKey());
+    QCOMPARE(box->scale(), 1.5);
+
+    // 提示与玩家选中互不覆盖：提示结束后选中的发光还在，取消选中后提示的发光还在
+    const QPixmap redGlow = atlas.decorated(sprite, 2, Qt::red, false);
+    box->activate(QColor(Qt::red).rgb());
+    box->hint(true);
+    QCOMPARE(box->pixmap().cacheKey(), redGlow.cacheKey());
+    box->hint(false);
+    QCOMPARE(box->pixmap().cacheKey(), redGlow.cacheKey());
+    box->hint(true);
+    box->deactivate();
+    QCOMPARE(box->pixmap().cacheKey(), glow.cacheKey());
+    box->hint(false);
+    QCOMPARE(box->pixmap().cacheKey(), sprite.cacheKey());
+
+    delete scene;
+    qDebug() << "Cached highlight looks test passed!";
+}
+
+void SimpleTest::testPreselectChangeOnly()
+{
+    qDebug() << "Testing change-only preselection...";
+
+    QVector<QVector<int>> testMap = {
+        {-1, -1, -1},
+        {-1,  1, -1},
+        {-1, -1, -1}
+    };
+    QGraphicsScene* scene = new QGraphicsScene(0, 0, 800, 600);
+    Map map(3, 3, 1, ":/assets/ingredient.png", scene, 26);
+    map.setMapData(testMap);
+    Box* box = map.m_boxes.first();
+    const qint64 plain = box->pixmap().cacheKey();
+
+    // A 在箱子右侧向右走开，B 在箱子下方向下走开，每 tick 移动 8 像素
+    Character a(":/assets/sprites0.png", QPointF(800, 600));
+    Character b(":/assets/sprites1.png", QPointF(800, 600));
+    a.setControls({ Qt::Key_W, Qt::Key_S, Qt::Key_A, Qt::Key_D });
+    b.setControls({ Qt::Key_Up, Qt::Key_Down, Qt::Key_Left, Qt::Key_Right });
+    a.setGameMap(&map);
+    b.setGameMap(&map);
+    a.setPos(box->pos() + QPointF(30, 0));
+    b.setPos(box->pos() + QPointF(0, 20));
+    QKeyEvent right(QEvent::KeyPress, Qt::Key_D, Qt::NoModifier);
+    QKeyEvent down(QEvent::KeyPress, Qt::Key_Down, Qt::NoModifier);
+    a.handleKeyPress(&right);
+    b.handleKeyPress(&down);
+
+    // 两人都靠近：遮罩只加一次
+    QMetaObject::invokeMethod(&a, "updateMovement");
+    QMetaObject::invokeMethod(&b, "updateMovement");
+    const qint64 preselected = box->pixmap().cacheKey();
+    QVERIFY(preselected != plain);
+
+    // 目标不变的 tick 不改动箱子；A 走远后 B 仍靠近，遮罩保留
+    for (int i = 0; i < 3; ++i)
+        QMetaObject::invokeMethod(&a, "updateMovement");
+    QVERIFY(a.pos().x() - box->pos().x() > 48);
+    QCOMPARE(box->pixmap().cacheKey(), preselected);
+
+    // B 也走远后恢复原贴图（重复的 preAct 若被计数，这里就恢复不了）
+    for (int i = 0; i < 4; ++i)
+        QMetaObject::invokeMethod(&b, "updateMovement");
+    QCOMPARE(box->pixmap().cacheKey(), plain);
+
+    delete scene;
+    qDebug() << "Change-only preselection test passed!";
+}
+
+void SimpleTest::testNearbyLookup()
+{
+    qDebug() << "Testing lattice lookup...";
+
+    QVector<QVector<int>> testMap = {
+        {1, 2, 3, 4, 5},
+        {6, 7, 8, 9, 1},
+        {2, 3, -1, 5, 6},
+        {7, 8, 9, 1, 2},
+        {3, 4, 5, 6, 7}
+    };
+    QGraphicsScene* scene = new QGraphicsScene(0, 0, 800, 600);
+    Map map(5, 5, 9, ":/assets/ingredient.png", scene, 26);
+    map.setMapData(testMap);
+
+    // 格子索引与箱子一一对应，格点坐标能换算回格子
+    for (Box* box : map.m_boxes) {
+        QCOMPARE(map.boxAt(box->row, box->col), box);
+        QCOMPARE(map.cellAt(box->pos()), QPoint(box->col, box->row));
+    }
+    QVERIFY(!map.boxAt(2, 2));
+    QVERIFY(!map.boxAt(-1, 0));
+    QVERIFY(!map.boxAt(0, 5));
+
+    // 只返回周围 3x3 格的箱子
+    QVector<Box*> near;
+    map.boxesNear(map.cellCenterPx(2, 2), near);
+    QCOMPARE(near.size(), 8);
+    for (Box* box : near)
+        QVERIFY(qAbs(box->row - 2) <= 1 && qAbs(box->col - 2) <= 1);
+    map.boxesNear(map.cellCenterPx(0, 0) + QPointF(5, 5), near);
+    QCOMPARE(near.size(), 4);
+    map.boxesNear(map.cellCenterPx(-3, -3), near);
+    QVERIFY(near.isEmpty());
+
+    // 消除后索引同步
+    Box* gone = map.boxAt(1, 1);
+    map.m_boxes.removeOne(gone);
+    map.setCell(1, 1, -1);
+    delete gone;
+    map.boxesNear(map.cellCenterPx(2, 2), near);
+    QCOMPARE(near.size(), 7);
+
+    // 道具登记与注销
+    Box* tool = new Box(map.cellCenterPx(2, 2), "", scene);
+    tool->row = 2;
+    tool->col = 2;
+    tool->toolType = 1;
+    map.addTool(tool);
+    QCOMPARE(map.toolAt(2, 2), tool);
+    map.toolsNear(map.cellCenterPx(1, 2), near);
+    QCOMPARE(near.size(), 1);
+    map.removeTool(tool);
+    QVERIFY(!map.toolAt(2, 2));
+    QVERIFY(!map.m_tools.contains(tool));
+    delete tool;
+
+    delete scene;
+    qDebug() << "Lattice lookup test passed!";
+}
+
+void SimpleTest::testContactPerKeyPress()
+{
+    qDebug() << "Testing box contact per key press...";
+
+    QVector<QVector<int>> testMap = {
+        {-1, -1, -1},
+        {-1,  1, -1},
+        {-1, -1, -1}
+    };
+    QGraphicsScene* scene = new QGraphicsScene(0, 0, 800, 600);
+    Map map(3, 3, 1, ":/assets/ingredient.png", scene, 26);
+    map.setMapData(testMap);
+    Box* box = map.m_boxes.first();
+
+    Character c(":/assets/sprites0.png", QPointF(800, 600));
+    c.setControls({ Qt::Key_W, Qt::Key_S, Qt::Key_A, Qt::Key_D });
+    c.setGameMap(&map);
+    int contacts = 0;
+    QObject::connect(&c, &Character::collidedWithBox, [&contacts](Box*, Character*) { ++contacts; });
+
+    QKeyEvent down(QEvent::KeyPress, Qt::Key_S, Qt::NoModifier);
+    QKeyEvent downRepeat(QEvent::KeyPress, Qt::Key_S, Qt::NoModifier, QString(), true);
+    QKeyEvent releaseDown(QEvent::KeyRelease, Qt::Key_S, Qt::NoModifier);
+
+    // 在箱子正上方向下顶：碰撞后停住，通知一次
+    c.setPos(box->pos() + QPointF(0, -30));
+    c.handleKeyPress(&down);
+    QMetaObject::invokeMethod(&c, "updateMovement");
+    QCOMPARE(contacts, 1);
+
+    // 按住不放（含自动重复）不会每个 tick 重复通知
+    for (int i = 0; i < 10; ++i) {
+        c.handleKeyPress(&downRepeat);
+        QMetaObject::invokeMethod(&c, "updateMovement");
+    }
+    QCOMPARE(contacts, 1);
+
+    // 松开再按是一次新的操作（再次选中/取消），照常通知
+    c.handleKeyRelease(&releaseDown);
+    c.handleKeyPress(&down);
+    QMetaObject::invokeMethod(&c, "updateMovement");
+    QCOMPARE(contacts, 2);
+
+    delete scene;
+    qDebug() << "Box contact per key press test passed!";
+}
+
+void SimpleTest::testGameLoop()
+{
+    qDebug() << "Testing fixed-step game loop...";
+
+    // 周期计数：返回这一步跨过了几个周期，余数留到下一步
+    Cadence cadence(200);
+    QCOMPARE(cadence.advance(150), 0);
+    QCOMPARE(cadence.advance(100), 1);
+    QCOMPARE(cadence.advance(450), 2);
+    QCOMPARE(cadence.accumMs, 150);
+
+    // tick 数跟随真实经过的时间，每次都是固定步长
+    GameLoop loop(10);
+    int ticks = 0;
+    bool fixedStep = true;
+    QObject::connect(&loop, &GameLoop::tick, [&](int stepMs) {
+        fixedStep = fixedStep && stepMs == 10;
+        ++ticks;
+    });
+    QElapsedTimer wall;
+    wall.start();
+    loop.start();
+    QTest::qWait(300);
+    loop.stop();
+    const qint64 expected = wall.elapsed() / 10;
+
+    QVERIFY(fixedStep);
+    QCOMPARE(loop.tickCount(), qint64(ticks));
+    QCOMPARE(loop.elapsedMs(), qint64(ticks) * 10);
+    QVERIFY(ticks <= expected + 1);
+    QVERIFY(ticks >= expected / 2);
+    QVERIFY(loop.jitter().samples > 0);
+    QVERIFY(loop.jitter().maxMs >= loop.jitter().meanMs);
+
+    qDebug() << "Fixed-step game loop test passed!";
+}
+
+void SimpleTest::testGameClock()
+{
+    qDebug() << "Testing injectable game clock...";
+
+    // 暂停时游戏时间冻结，advance() 单步推进
+    GameClock clock;
+    clock.setPaused(true);
+    const qint64 frozen = clock.nowMs();
+    QTest::qWait(20);
+    QCOMPARE(clock.nowMs(), frozen);
+    clock.advance(500);
+    QCOMPARE(clock.nowMs(), frozen + 500);
+
+    // 100 倍速：20ms 真实时间至少走过 1.5s 游戏时间
+    clock.setTimeScale(100);
+    clock.setPaused(false);
+    QTest::qWait(20);
+    QVERIFY(clock.nowMs() - frozen - 500 >= 1500);
+
+    // 无界面模拟：不启动定时器，尽快跑完 10s 游戏时间，道具按游戏时间到时消失
+    QVector<QVector<int>> testMap = {
+        {1, -1, 1},
+        {-1, -1, -1}
+    };
+    QGraphicsScene* scene = new QGraphicsScene(0, 0, 800, 600);
+    Map map(2, 3, 1, ":/assets/ingredient.png", scene, 26);
+    map.setMapData(testMap);
+    TimerWheel timers(33);
+    PowerUpManager powerUps;
+    powerUps.initialize(&map, scene, &timers);
+    powerUps.spawnPowerUp(1);
+    QCOMPARE(map.m_tools.size(), 1);
+
+    GameLoop loop(33);
+    loop.setClock(&clock);
+    QObject::connect(&loop, &GameLoop::tick, &powerUps, &PowerUpManager::update);
+    QObject::connect(&loop, &GameLoop::tick, [&](int dt) { timers.advance(dt); });
+    QElapsedTimer wall;
+    wall.start();
+    loop.runFor(9900);
+    QCOMPARE(map.m_tools.size(), 1);
+    loop.runFor(200);
+    QCOMPARE(map.m_tools.size(), 0);
+    QVERIFY(loop.elapsedMs() >= 10000);
+    QVERIFY(wall.elapsed() < 1000);
+
+    // tick 中 stop() 让 runSteps 提前返回
+    int ticks = 0;
+    QObject::connect(&loop, &GameLoop::tick, [&](int) { if (++ticks == 3) loop.stop(); });
+    QCOMPARE(loop.runSteps(10), 3);
+
+    delete scene;
+    qDebug() << "Injectable game clock test passed!";
+}
+
+void SimpleTest::testTimerWheel()
+{
+    qDebug() << "Testing session timer wheel...";
+
+    // 大量定时器（含跨层的长延时）都恰好在到期的刻度上执行，取消的不执行
+    TimerWheel wheel(10);
+    QVector<TimerWheel::Handle> handles;
+    QVector<qint64> lateness;
+    int fired = 0;
+    for (int i = 0; i < 500; ++i) {
+        const int delay = (i * 7919) % (i % 5 == 0 ? 3000000 : 5000);
+        const qint64 due = qMax(1, (delay + 9) / 10) * 10;
+        handles.append(wheel.schedule(delay, [&, due]() { ++fired; lateness.append(wheel.nowMs() - due); }));
+    }
+    int cancelled = 0;
+    for (int i = 0; i < handles.size(); i += 3) {
+        QVERIFY(wheel.cancel(handles[i]));
+        QVERIFY(!wheel.cancel(handles[i]));
+        ++cancelled;
+    }
+    QCOMPARE(wheel.pendingCount(), 500 - cancelled);
+    for (int t = 0; t < 300100; ++t) wheel.advance(10);
+    QCOMPARE(fired, 500 - cancelled);
+    QCOMPARE(wheel.pendingCount(), 0);
+    for (qint64 late : lateness) QCOMPARE(late, qint64(0));
+
+    // 回调里取消同一刻度的其他定时器、再登记新的
+    int hits = 0;
+    TimerWheel::Handle sibling;
+    wheel.schedule(50, [&]() { ++hits; wheel.cancel(sibling); wheel.schedule(0, [&]() { hits += 10; }); });
+    sibling = wheel.schedule(50, [&]() { hits += 100; });
+    wheel.advance(50);
+    QCOMPARE(hits, 1);
+    wheel.advance(10);
+    QCOMPARE(hits, 11);
+
+    // clear() 之后旧句柄失效、回调不再执行；不推进（暂停）就不会到期
+    TimerWheel::Handle pending = wheel.schedule(100, [&]() { hits = -1; });
+    QVERIFY(wheel.isPending(pending));
+    wheel.clear();
+    QVERIFY(!wheel.isPending(pending));
+    wheel.advance(1000);
+    QCOMPARE(hits, 11);
+
+    // 拾取道具时取消它的自动消失定时器
+    QVector<QVector<int>> testMap = {
+        {1, -1, 1},
+        {-1, -1, -1}
+    };
+    QGraphicsScene* scene = new QGraphicsScene(0, 0, 800, 600);
+    Map map(2, 3, 1, ":/assets/ingredient.png", scene, 26);
+    map.setMapData(testMap);
+    PowerUpManager powerUps;
+    powerUps.initialize(&map, scene, &wheel);
+    powerUps.spawnPowerUp(1);
+    QCOMPARE(wheel.pendingCount(), 1);
+    powerUps.removePowerUp(map.m_tools.first());
+    QCOMPARE(wheel.pendingCount(), 0);
+    QCOMPARE(map.m_tools.size(), 0);
+
+    delete scene;
+    qDebug() << "Session timer wheel test passed!";
+}
+
+void SimpleTest::testEffectPool()
+{
+    qDebug() << "Testing pooled effect items...";
+
+    QGraphicsScene* scene = new QGraphicsScene(0, 0, 800, 600);
+    const int baseItems = scene->items().size();
+    EffectPool* pool = new EffectPool(scene, 2);
+    QCOMPARE(scene->items().size(), baseItems + 4);
+    QCOMPARE(pool->idlePathCount(), 2);
+
+    // 连击：同时显示的不超过预分配数时只复用，不新建图元
+    QPainterPath path(QPointF(0, 0));
+    path.lineTo(100, 0);
+    for (int round = 0; round < 50; ++round) {
+        QGraphicsPathItem* a = pool->showPath(path);
+        QGraphicsPathItem* b = pool->showPath(path);
+        QGraphicsTextItem* text = pool->showText("+1s", Qt::green, QPointF(round, round));
+        QVERIFY(a != b);
+        QVERIFY(a->isVisible() && b->isVisible() && text->isVisible());
+        QCOMPARE(text->toPlainText(), QString("+1s"));
+        QCOMPARE(text->pos(), QPointF(round, round));
+        pool->release(a);
+        pool->release(b);
+        pool->release(text);
+        pool->release(text);     // 重复归还无影响
+        QVERIFY(!a->isVisible());
+    }
+    QCOMPARE(pool->pathCount(), 2);
+    QCOMPARE(pool->textCount(), 2);
+    QCOMPARE(pool->idleTextCount(), 2);
+    QCOMPARE(scene->items().size(), baseItems + 4);
+
+    // 空闲不够时才扩容，扩出来的也留在池里复用
+    QVector<QGraphicsTextItem*> shown;
+    for (int i = 0; i < 3; ++i) shown.append(pool->showText("Hint!", Qt::yellow, QPointF()));
+    QCOMPARE(pool->textCount(), 3);
+    for (QGraphicsTextItem* item : shown) pool->release(item);
+    QCOMPARE(pool->idleTextCount(), 3);
+
+    // 销毁时把全部图元从场景移除
+    delete pool;
+    QCOMPARE(scene->items().size(), baseItems);
+
+    delete scene;
+    qDebug() << "Pooled effect items test passed!";
+}
+
+void SimpleTest::testProfiler()
+{
+    qDebug() << "Testing scoped profiler...";
+
+    Profiler &profiler = Profiler::instance();
+    const int section = profiler.section("test-section");
+    QCOMPARE(profiler.section("test-section"), section);
+    QCOMPARE(profiler.sectionName(section), QString("test-section"));
+
+    // 滚动窗口只保留最近 kWindow 个样本，直方图累计全部样本
+    profiler.record(section, 5000000);     // 5ms，随后被挤出窗口
+    for (int i = 0; i < Profiler::kWindow; ++i)
+        profiler.record(section, 1000000);  // 1ms
+    Profiler::Stats stats = profiler.stats(section);
+    QCOMPARE(stats.count, qint64(Profiler::kWindow + 1));
+    QCOMPARE(stats.lastMs, 1.0);
+    QCOMPARE(stats.meanMs, 1.0);
+    QCOMPARE(stats.maxMs, 1.0);
+
+    QString dump;
+    QTextStream out(&dump);
+    profiler.dumpHistograms(out);
+    out.flush();
+    QVERIFY(dump.contains("test-section: samples 121"));
+    QVERIFY(dump.contains("512-1024us\t120"));
+    QVERIFY(dump.contains("4096-8192us\t1"));
+
+    // 开启计时的构建里，作用域宏按实际经过时间记样本
+    if (Profiler::isEnabled()) {
+        {
+            PROFILE_SCOPE("test-scope");
+            QTest::qWait(5);
+        }
+        int scope = -1;
+        for (int i = 0; i < profiler.sectionCount(); ++i)
+            if (profiler.sectionName(i) == "test-scope") scope = i;
+        QVERIFY(scope >= 0);
+        QCOMPARE(profiler.stats(scope).count, qint64(1));
+        QVERIFY(profiler.stats(scope).lastMs >= 4.0);
+    }
+
+    profiler.reset();
+    QCOMPARE(profiler.stats(section).count, qint64(0));
+    qDebug() << "Scoped profiler test passed!";
+}
+
+void SimpleTest::testTracer()
+{
+    qDebug() << "Testing chrome trace recording...";
+
+    Tracer &tracer = Tracer::instance();
+    tracer.clear();
+
+    // 未开启时不记录
+    tracer.setEnabled(false);
+    {
+        TRACE_SCOPE("disabled");
+    }
+    QCOMPARE(tracer.eventCount(), 0);
+
+    // 主线程与工作线程各自写自己的缓冲；工作线程写满后只保留最新的 kBufferEvents 条
+    tracer.setEnabled(true);
+    QGraphicsScene* scene = new QGraphicsScene();
+    Map map(2, 2, 1, ":/assets/ingredient.png", scene, 26);
+    map.setMapData({ {1, 1}, {-1, -1} });
+    QVERIFY(map.canConnect(map.boxAt(0, 0), map.boxAt(0, 1)));
+    std::thread worker([]() {
+        for (int i = 0; i < Tracer::kBufferEvents + 100; ++i) {
+            TRACE_SCOPE("worker");
+        }
+    });
+    worker.join();
+    tracer.setEnabled(false);
+
+    const QJsonObject root = QJsonDocument::fromJson(tracer.toJson()).object();
+    const QJsonArray events = root.value("traceEvents").toArray();
+    QSet<QString> names;
+    QSet<int> tids;
+    int workerEvents = 0;
+    for (const QJsonValue &value : events) {
+        const QJsonObject e = value.toObject();
+        if (e.value("ph").toString() != "X") continue;
+        names.insert(e.value("name").toString());
+        tids.insert(e.value("tid").toInt());
+        QVERIFY(e.value("dur").toDouble() >= 0);
+        if (e.value("name").toString() == "worker") ++workerEvents;
+    }
+    QVERIFY(names.contains("Map::setMapData"));
+    QVERIFY(names.contains("Map::canConnect"));
+    QVERIFY(!names.contains("disabled"));
+    QCOMPARE(workerEvents, Tracer::kBufferEvents);
+    QVERIFY(tids.size() >= 2);
+
+    tracer.clear();
+    QCOMPARE(tracer.eventCount(), 0);
+    delete scene;
+    qDebug() << "Chrome trace recording test passed!";
+}
+
+// testSessionMemory 的一局：开局、记下局中快照、消掉一对（选消完后仍有可消对的，避免弹出结束对话框）、清理
+// 里面的 QVERIFY/QCOMPARE 失败时只从这里返回，调用方须检查 QTest::currentTestFailed()
+static void playSessionCycle(MainWindow& window, MemoryReport* inGame)
+{
+    const auto flush = []() { QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete); };
+
+    window.startGame(2);
+    flush();
+    *inGame = window.memoryReport();
+    GameView* view = window.findChild<GameView*>();
+    QVERIFY(view && view->scene());
+    const QList<Character*> players = window.findChildren<Character*>();
+    QCOMPARE(players.size(), 2);
+
+    QVector<Box*> boxes;
+    int rows = 0, cols = 0;
+    for (QGraphicsItem* item : view->scene()->items()) {
+        Box* box = dynamic_cast<Box*>(item);
+        if (!box || box->toolType >= 1) continue;
+        boxes.append(box);
+        rows = qMax(rows, box->row + 1);
+        cols = qMax(cols, box->col + 1);
+    }
+    // 同类型的箱子共用图集里同一帧（隐式共享），按贴图的 cacheKey 区分类型
+    QVector<QVector<int>> cells(rows, QVector<int>(cols, -1));
+    QHash<qint64, int> typeOf;
+    QHash<int, Box*> byCell;
+    for (Box* box : boxes) {
+        const qint64 key = box->pixmap().cacheKey();
+        if (!typeOf.contains(key)) typeOf.insert(key, typeOf.size());
+        cells[box->row][box->col] = typeOf.value(key);
+        byCell.insert((box->row + 1) * (cols + 2) + box->col + 1, box);
+    }
+    const BoardGrid grid(cells);
+    QPair<int, int> pick(-1, -1);
+    for (const QPair<int, int> &move : grid.allMoves()) {
+        BoardGrid after = grid;
+        after.set(move.first / grid.stride(), move.first % grid.stride(), -1);
+        after.set(move.second / grid.stride(), move.second % grid.stride(), -1);
+        if (after.findAnyMove()) { pick = move; break; }
+    }
+    QVERIFY(pick.first != -1);
+
+    const int liveBefore = Box::liveCount();
+    Character* player = players.first();
+    emit player->collidedWithBox(byCell.value(pick.first), player);
+    emit player->collidedWithBox(byCell.value(pick.second), player);
+    QCOMPARE(Box::liveCount(), liveBefore - 2);   // 消掉的箱子立即释放
+
+    window.cleanupGameResources();
+    flush();
+}
+
+void SimpleTest::testSessionMemory()
+{
+    qDebug() << "Testing memory across start/cleanup cycles...";
+
+    // 之前的用例可能留下自己的箱子，只比较本用例前后的差值
+    const int boxesBefore = Box::liveCount();
+    const int charactersBefore = Character::liveCount();
+
+    MainWindow window;
+
+    // 预热一局：图集解码等一次性开销不计入增长
+    MemoryReport warmGame;
+    playSessionCycle(window, &warmGame);
+    if (QTest::currentTestFailed()) return;
+    const MemoryReport baseline = window.memoryReport();
+    const int baseObjects = window.findChildren<QObject*>().size();
+    QVERIFY(warmGame.boxes > boxesBefore);
+    QCOMPARE(warmGame.characters, charactersBefore + 2);
+    QVERIFY(warmGame.mapBytes > 0);
+    QVERIFY(warmGame.sceneItems > warmGame.boxes - boxesBefore);
+    QCOMPARE(baseline.boxes, boxesBefore);
+    QCOMPARE(baseline.characters, charactersBefore);
+
+    // 同样大小的棋盘，每局开局时的存活对象数应完全相同，清理后回到基线
+    // 高亮贴图缓存按（帧, 外观）登记，随消过的类型增长但有上限，不算泄漏，只比较精灵图本身
+    const int cycles = 5;
+    for (int i = 0; i < cycles; ++i) {
+        MemoryReport inGame;
+        playSessionCycle(window, &inGame);
+        if (QTest::currentTestFailed()) return;
+        QCOMPARE(inGame.boxes, warmGame.boxes);
+        QCOMPARE(inGame.characters, warmGame.characters);
+        QCOMPARE(inGame.transientItems, warmGame.transientItems);
+        QCOMPARE(inGame.sceneItems, warmGame.sceneItems);
+    }
+
+    const MemoryReport report = window.memoryReport();
+    for (const QString &line : report.lines()) qDebug().noquote() << line;
+    QCOMPARE(report.boxes, baseline.boxes);
+    QCOMPARE(report.characters, baseline.characters);
+    QCOMPARE(report.sheetBytes, baseline.sheetBytes);
+    QCOMPARE(report.mapBytes, qint64(0));
+    QCOMPARE(window.findChildren<QObject*>().size(), baseObjects);   // 场景、菜单、角色等不随局数累积
+    qDebug() << "Session memory test passed!";
+}
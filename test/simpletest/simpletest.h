@@ -21,4 +21,28 @@ private slots:
     void testTwoTurnConnect();
     void testCannotConnect();
     void testComplexCase();
+    void testConnectAfterRemoval();
+    void testWideBoardConnect();
+    void testMoveIndexUpdates();
+    void testEnumerateMoves();
+    void testMaxTurnsRule();
+    void testFindPathConcurrent();
+    void testParallelMoveSearch();
+    void testBoardSolver();
+    void testBoardSolverBudget();
+    void testBoardGenerator();
+    void testShuffleKeepsMove();
+    void testSpriteAtlas();
+    void testBoardLayer();
+    void testHighlightLooks();
+    void testPreselectChangeOnly();
+    void testNearbyLookup();
+    void testContactPerKeyPress();
+    void testGameLoop();
+    void testGameClock();
+    void testTimerWheel();
+    void testEffectPool();
+    void testProfiler();
+    void testTracer();
+    void testSessionMemory();
 };